@@ -2,6 +2,9 @@
 
 #include "Utils/ScopedUnprotect.hpp"
 #include <cmath>
+#include <string>
+#include <unordered_map>
+#include <xmmintrin.h>
 #include <Shlwapi.h>
 
 #pragma comment(lib, "Shlwapi.lib")
@@ -41,11 +44,77 @@ const Graphics_Config& Graphics_GetCurrentConfig()
 	return *gGraphicsConfig;
 }
 
+uint32_t Graphics_Config_GetChangedFields(const Graphics_Config& from, const Graphics_Config& to)
+{
+	uint32_t result = 0;
+	if (from.m_resWidth != to.m_resWidth || from.m_resHeight != to.m_resHeight) result |= ConfigField::RESOLUTION;
+	if (from.m_format != to.m_format) result |= ConfigField::FORMAT;
+	if (from.m_refreshRate != to.m_refreshRate) result |= ConfigField::REFRESH_RATE;
+	if (from.m_autoDepthStencil != to.m_autoDepthStencil) result |= ConfigField::DEPTH_STENCIL;
+	if (from.m_backBufferCount != to.m_backBufferCount) result |= ConfigField::BACK_BUFFERS;
+	if (from.m_multiSampleType != to.m_multiSampleType) result |= ConfigField::MULTISAMPLE;
+	if (from.m_adapter != to.m_adapter) result |= ConfigField::ADAPTER;
+	if (!EqualRect(&from.m_windowRect, &to.m_windowRect)) result |= ConfigField::WINDOW_RECT;
+	if (from.m_windowed != to.m_windowed || from.m_borderless != to.m_borderless) result |= ConfigField::DISPLAY_MODE;
+	if (from.m_presentationInterval != to.m_presentationInterval) result |= ConfigField::PRESENT_INTERVAL;
+	return result;
+}
+
+bool Graphics_Config_RequiresDeviceReset(const Graphics_Config& from, const Graphics_Config& to)
+{
+	uint32_t changedFields = Graphics_Config_GetChangedFields(from, to);
+
+	// Windowed modes run at the desktop refresh rate, so it doesn't matter there
+	if (from.m_windowed != 0 && to.m_windowed != 0)
+	{
+		changedFields &= ~ConfigField::REFRESH_RATE;
+	}
+	return (changedFields & ConfigField::DEVICE_RESET_MASK) != 0;
+}
+
 float GetScaledResolutionWidth()
 {
 	return UIFullyPatched ? 480.0f * (static_cast<float>(Graphics_GetScreenWidth()) / Graphics_GetScreenHeight()) : 640.0f;
 }
 
+// Anchor offsets used by the _Center/_RightAlign wrappers, so they don't query the resolution on every call
+// Recalculated together with the rest of the UI, defaults are valid for the unpatched 640px wide UI
+struct UIAnchors
+{
+	float m_scaledWidth = 640.0f;
+	float m_scaledHalfWidth = 320.0f;
+
+	// In screen pixels, for blits already multiplied for resolution
+	float m_blitCenterOffset = 0.0f;
+	float m_blitCenterHalfOffset = 0.0f;
+	float m_blitRightOffset = 0.0f;
+};
+static UIAnchors gUIAnchors;
+
+static void RecalculateUIAnchors()
+{
+	const float resolutionWidth = static_cast<float>(Graphics_GetScreenWidth());
+	const float scaledWidth = GetScaledResolutionWidth();
+
+	gUIAnchors.m_scaledWidth = scaledWidth;
+	gUIAnchors.m_scaledHalfWidth = scaledWidth / 2.0f;
+	gUIAnchors.m_blitCenterOffset = (resolutionWidth / 2.0f) - (320.0f * (resolutionWidth / scaledWidth));
+	gUIAnchors.m_blitCenterHalfOffset = (resolutionWidth / 4.0f) - (160.0f * (resolutionWidth / scaledWidth));
+	gUIAnchors.m_blitRightOffset = resolutionWidth - (640.0f * (resolutionWidth / scaledWidth));
+}
+
+// X[0] and X[1] are adjacent in all 2D blits, so both are translated with a single 64-bit load/add/store
+template<typename T>
+static void TranslateBlitsX(T* blits, uint32_t numBlits, float offset)
+{
+	const __m128 offsetVec = _mm_set1_ps(offset);
+	for (uint32_t i = 0; i < numBlits; ++i)
+	{
+		__m64* X = reinterpret_cast<__m64*>(blits[i].X);
+		_mm_storel_pi(X, _mm_add_ps(_mm_loadl_pi(offsetVec, X), offsetVec));
+	}
+}
+
 void Core_Texture_SetFilteringMethod(D3DTexture* texture, uint32_t min, uint32_t mag, uint32_t mip)
 {
 	if (texture != nullptr)
@@ -67,16 +136,14 @@ void Texture_DestroyManaged(D3DTexture** texture)
 
 OSD_Element* OSD_Element_Init_Center(OSD_Element* element, int posX, int posY, int width, int height, int a6, int a7, int a8, int a9, int a10, int a11)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = posX - 320;
-	return OSD_Element_Init(element, static_cast<int>(scaledWidth / 2 + offset), posY, width, height, a6, a7, a8, a9, a10, a11);
+	return OSD_Element_Init(element, static_cast<int>(gUIAnchors.m_scaledHalfWidth + offset), posY, width, height, a6, a7, a8, a9, a10, a11);
 }
 
 OSD_Element* OSD_Element_Init_RightAlign(OSD_Element* element, int posX, int posY, int width, int height, int a6, int a7, int a8, int a9, int a10, int a11)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = 640 - posX;
-	return OSD_Element_Init(element, static_cast<int>(scaledWidth - offset), posY, width, height, a6, a7, a8, a9, a10, a11);
+	return OSD_Element_Init(element, static_cast<int>(gUIAnchors.m_scaledWidth - offset), posY, width, height, a6, a7, a8, a9, a10, a11);
 }
 
 OSD_Element* OSD_Element_Init(OSD_Element* element, int posX, int posY, int width, int height, int a6, int a7, int a8, int a9, int a10, int a11)
@@ -100,60 +167,25 @@ OSD_Element* OSD_Element_Init(OSD_Element* element, int posX, int posY, int widt
 
 void Core_Blitter2D_Rect2D_G_Center(BlitRect2D_G* rects, uint32_t numRectangles)
 {
-	const float resolutionWidth = static_cast<float>(Graphics_GetScreenWidth());
-	const float scaledOldCenter = 320.0f * (resolutionWidth / GetScaledResolutionWidth());
-	const float scaledRealCenter = resolutionWidth / 2.0f;
-	const float offset = scaledRealCenter - scaledOldCenter;
-	for (uint32_t i = 0; i < numRectangles; ++i)
-	{
-		// Those rectangles are already multiplied for resolution
-		rects[i].X[0] += offset;
-		rects[i].X[1] += offset;
-	}
+	TranslateBlitsX(rects, numRectangles, gUIAnchors.m_blitCenterOffset);
 	Core_Blitter2D_Rect2D_G(rects, numRectangles);
 }
 
 void Core_Blitter2D_Line2D_G_Center(BlitLine2D_G* lines, uint32_t numLines)
 {
-	const float resolutionWidth = static_cast<float>(Graphics_GetScreenWidth());
-	const float scaledOldCenter = 320.0f * (resolutionWidth / GetScaledResolutionWidth());
-	const float scaledRealCenter = resolutionWidth / 2.0f;
-	const float offset = scaledRealCenter - scaledOldCenter;
-	for (uint32_t i = 0; i < numLines; ++i)
-	{
-		// Those rectangles are already multiplied for resolution
-		lines[i].X[0] += offset;
-		lines[i].X[1] += offset;
-	}
+	TranslateBlitsX(lines, numLines, gUIAnchors.m_blitCenterOffset);
 	Core_Blitter2D_Line2D_G(lines, numLines);
 }
 
 void Core_Blitter2D_Rect2D_GT_CenterHalf(BlitRect2D_GT* rects, uint32_t numRectangles)
 {
-	const float resolutionWidth = static_cast<float>(Graphics_GetScreenWidth());
-	const float scaledOldCenter = 160.0f * (resolutionWidth / GetScaledResolutionWidth());
-	const float scaledRealCenter = resolutionWidth / 4.0f;
-	const float offset = scaledRealCenter - scaledOldCenter;
-	for (uint32_t i = 0; i < numRectangles; ++i)
-	{
-		// Those rectangles are already multiplied for resolution
-		rects[i].X[0] += offset;
-		rects[i].X[1] += offset;
-	}
+	TranslateBlitsX(rects, numRectangles, gUIAnchors.m_blitCenterHalfOffset);
 	Core_Blitter2D_Rect2D_GT(rects, numRectangles);
 }
 
 void Core_Blitter2D_Rect2D_GT_RightAlign(BlitRect2D_GT* rects, uint32_t numRectangles)
 {
-	const float resolutionWidth = static_cast<float>(Graphics_GetScreenWidth());
-	const float scaledOldRight = 640.0f * (resolutionWidth / GetScaledResolutionWidth());
-	const float offset = resolutionWidth - scaledOldRight;
-	for (uint32_t i = 0; i < numRectangles; ++i)
-	{
-		// Those rectangles are already multiplied for resolution
-		rects[i].X[0] += offset;
-		rects[i].X[1] += offset;
-	}
+	TranslateBlitsX(rects, numRectangles, gUIAnchors.m_blitRightOffset);
 	Core_Blitter2D_Rect2D_GT(rects, numRectangles);
 }
 
@@ -165,36 +197,81 @@ void HandyFunction_Draw2DBox_Stretch(int posX, int posY, int width, int height,
 
 void HandyFunction_Draw2DBox_Center(int posX, int posY, int width, int height, int color)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = posX - 320;
-	HandyFunction_Draw2DBox(static_cast<int>(scaledWidth / 2 + offset), posY, width + 1, height, color);
+	HandyFunction_Draw2DBox(static_cast<int>(gUIAnchors.m_scaledHalfWidth + offset), posY, width + 1, height, color);
 }
 
 void HandyFunction_Draw2DBox_RightAlign(int posX, int posY, int width, int height, int color)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = 640 - posX;
-	HandyFunction_Draw2DBox(static_cast<int>(scaledWidth - offset), posY, width + 1, height, color);
+	HandyFunction_Draw2DBox(static_cast<int>(gUIAnchors.m_scaledWidth - offset), posY, width + 1, height, color);
 }
 
 void HandyFunction_Draw2DLineFromTo_Center(float x1, float y1, float x2, float y2, uint32_t* z, uint32_t color)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
-	HandyFunction_Draw2DLineFromTo((scaledWidth / 2.0f) + x1 - 320.0f, y1, (scaledWidth / 2.0f) + x2 - 320.0f, y2, z, color);
+	const float scaledHalfWidth = gUIAnchors.m_scaledHalfWidth;
+	HandyFunction_Draw2DLineFromTo(scaledHalfWidth + x1 - 320.0f, y1, scaledHalfWidth + x2 - 320.0f, y2, z, color);
 }
 
 void CMR3Font_BlitText_Center(uint8_t a1, const char* text, int16_t posX, int16_t posY, uint32_t color, int align)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = posX - 320;
-	CMR3Font_BlitText(a1, text, static_cast<int16_t>(scaledWidth / 2 + offset), posY, color, align);
+	CMR3Font_BlitText(a1, text, static_cast<int16_t>(gUIAnchors.m_scaledHalfWidth + offset), posY, color, align);
 }
 
 void CMR3Font_BlitText_RightAlign(uint8_t a1, const char* text, int16_t posX, int16_t posY, uint32_t color, int align)
 {
-	const float scaledWidth = GetScaledResolutionWidth();
 	const int offset = 640 - posX;
-	CMR3Font_BlitText(a1, text, static_cast<int16_t>(scaledWidth - offset), posY, color, align);
+	CMR3Font_BlitText(a1, text, static_cast<int16_t>(gUIAnchors.m_scaledWidth - offset), posY, color, align);
+}
+
+// Widths are keyed by a 64-bit FNV-1a hash of the font ID and the text, so lookups don't allocate
+// Entries keep their font ID and text, so a hash collision is re-measured instead of returning another string's width
+struct CachedTextWidth
+{
+	std::string m_text;
+	uint8_t m_fontID;
+	int m_width;
+};
+static std::unordered_map<uint64_t, CachedTextWidth> gTextWidthCache;
+
+int CMR3Font_GetTextWidth_Cached(uint8_t fontID, const char* text)
+{
+	// Menus only ever measure a small set of strings, this only guards against unbounded growth
+	constexpr size_t MAX_CACHED_WIDTHS = 1024;
+
+	uint64_t hash = 14695981039346656037ull ^ fontID;
+	for (const char* c = text; *c != '\0'; c++)
+	{
+		hash = (hash * 1099511628211ull) ^ static_cast<uint8_t>(*c);
+	}
+
+	auto it = gTextWidthCache.find(hash);
+	if (it != gTextWidthCache.end())
+	{
+		CachedTextWidth& entry = it->second;
+		if (entry.m_fontID != fontID || entry.m_text != text)
+		{
+			entry.m_text = text;
+			entry.m_fontID = fontID;
+			entry.m_width = CMR3Font_GetTextWidth(fontID, text);
+		}
+		return entry.m_width;
+	}
+
+	if (gTextWidthCache.size() >= MAX_CACHED_WIDTHS)
+	{
+		gTextWidthCache.clear();
+	}
+
+	const int width = CMR3Font_GetTextWidth(fontID, text);
+	gTextWidthCache.emplace(hash, CachedTextWidth{text, fontID, width});
+	return width;
+}
+
+void CMR3Font_InvalidateTextWidths()
+{
+	gTextWidthCache.clear();
 }
 
 void Keyboard_DrawTextEntryBox_Center(int posX, int posY, int a3, int a4, uint32_t a5, int a6)
@@ -284,6 +361,7 @@ void RecalculateUI()
 	gAspectRatioMult = (4.0f * ResHeight) / (3.0f * ResWidth);
 
 	const float ScaledResWidth = 640.0f / gAspectRatioMult;
+	RecalculateUIAnchors();
 
 	auto centered = [ScaledResWidth](const auto& val)
 	{
@@ -346,6 +346,26 @@ inline uint8_t (*GameInfo_GetNumberOfPlayersInThisRace)();
 inline Graphics_Config* gGraphicsConfig;
 const Graphics_Config& Graphics_GetCurrentConfig();
 
+namespace ConfigField
+{
+	static constexpr uint32_t RESOLUTION = 1 << 0;
+	static constexpr uint32_t FORMAT = 1 << 1;
+	static constexpr uint32_t REFRESH_RATE = 1 << 2;
+	static constexpr uint32_t DEPTH_STENCIL = 1 << 3;
+	static constexpr uint32_t BACK_BUFFERS = 1 << 4;
+	static constexpr uint32_t MULTISAMPLE = 1 << 5;
+	static constexpr uint32_t ADAPTER = 1 << 6;
+	static constexpr uint32_t WINDOW_RECT = 1 << 7;
+	static constexpr uint32_t DISPLAY_MODE = 1 << 8; // Windowed/borderless
+	static constexpr uint32_t PRESENT_INTERVAL = 1 << 9;
+
+	// Everything apart from the window rect needs Graphics_Change and a device reset
+	static constexpr uint32_t DEVICE_RESET_MASK = RESOLUTION|FORMAT|REFRESH_RATE|DEPTH_STENCIL|BACK_BUFFERS|MULTISAMPLE|ADAPTER|DISPLAY_MODE|PRESENT_INTERVAL;
+}
+
+uint32_t Graphics_Config_GetChangedFields(const Graphics_Config& from, const Graphics_Config& to);
+bool Graphics_Config_RequiresDeviceReset(const Graphics_Config& from, const Graphics_Config& to);
+
 inline D3DViewport** gViewports;
 inline D3DViewport** gpFullScreenViewport;
 inline D3DViewport** gpCurrentViewport;
@@ -373,6 +393,10 @@ void HandyFunction_Draw2DLineFromTo_Center(float x1, float y1, float x2, float y
 void CMR3Font_BlitText_Center(uint8_t a1, const char* text, int16_t posX, int16_t posY, uint32_t color, int align);
 void CMR3Font_BlitText_RightAlign(uint8_t a1, const char* text, int16_t posX, int16_t posY, uint32_t color, int align);
 
+// Memoized CMR3Font_GetTextWidth, must be invalidated whenever fonts are (re)loaded
+int CMR3Font_GetTextWidth_Cached(uint8_t fontID, const char* text);
+void CMR3Font_InvalidateTextWidths();
+
 void Keyboard_DrawTextEntryBox_Center(int posX, int posY, int a3, int a4, uint32_t a5, int a6);
 
 uint32_t HandyFunction_AlphaCombineFlat(uint32_t color, uint32_t alpha);
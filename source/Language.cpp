@@ -3,7 +3,12 @@
 #include "Globals.h"
 #include "Version.h"
 
-#include <map>
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <vector>
 
 using namespace Language;
 
@@ -15,130 +20,237 @@ struct LangFile
 	const char* m_texts[1]; // VLA
 };
 
-static std::map<uint32_t, const char*> GetOverrideStrings()
+// SP strings are kept in constant packs of ID/text pairs, one per text language
+// They live entirely in .rdata, so adding a language costs no code and no startup allocations
+struct StringPackEntry
 {
-	std::map<uint32_t, const char*> result;
+	uint32_t m_ID;
+	const char* m_text;
+};
+
+class StringPack
+{
+public:
+	template<size_t N>
+	constexpr StringPack(const StringPackEntry (&entries)[N])
+		: m_entries(entries), m_numEntries(N)
+	{
+	}
+
+	const StringPackEntry* begin() const { return m_entries; }
+	const StringPackEntry* end() const { return m_entries + m_numEntries; }
+
+private:
+	const StringPackEntry* m_entries;
+	size_t m_numEntries;
+};
+
+static constexpr StringPackEntry COMMON_STRINGS[] = {
+	{ LANGUAGE_POLISH, "POLSKI" },
+	{ LANGUAGE_CZECH, "\xC3" "ESKY" },
+
+	{ 1008, "F1" }, { 1009, "F2" }, { 1010, "F3" }, { 1011, "F4" },
+	{ 1012, "F5" }, { 1013, "F6" }, { 1014, "F7" }, { 1015, "F8" },
+	{ 1016, "F9" }, { 1017, "F10" }, { 1018, "F11" }, { 1019, "F12" },
+
+	{ 1033, "[?]" },
+};
+
+// All strings that were hardcoded in the English release, but translated in the Polish release
+// + new strings for options
+static constexpr StringPackEntry POLISH_STRINGS[] = {
+	{ 994, "ND" },
+	{ 1004, "ENTER" }, { 1005, "ESC" }, { 1006, "BACKSPACE" }, { 1007, "TAB" },
+	{ 1020, "PRINTSCREEN" }, { 1021, "SCROLLLOCK" }, { 1022, "PAUZA" }, { 1023, "INSERT" },
+	{ 1024, "HOME" }, { 1025, "PGUP" }, { 1026, "DELETE" }, { 1027, "END" },
+	{ 1028, "PGDN" }, { 1029, "PRAWO" }, { 1030, "LEWO" }, { 1031, "G\xD3RA" },
+	{ 1032, "D\xD3\xA3" },
+
+	{ RETURN_TO_CENTRE, "POWR\xD3T DO POZ. NEUTRALNEJ" },
+
+	{ CODRIVER_POLISH_A, "JANUSZ KULIG" },
+	{ CODRIVER_POLISH_B, "JANUSZ WITUCH" },
+	{ CODRIVER_CZECH, "CZESKI" },
+
+	{ DISPLAY_MODE, "TRYB WY\x8CWIETLANIA" },
+	{ FULLSCREEN, "PE\xA3NY EKRAN" },
+	{ WINDOWED, "W OKNIE" },
+	{ BORDERLESS, "BEZ RAMKI" },
+	{ REFRESH_RATE, "CZ\xCAST. OD\x8CWIE\xAF" "ANIA" },
+	{ VSYNC, "SYNCHRONIZACJA PION." },
+	{ ANISOTROPIC, "FILTROWANIE ANIZOTROPOWE" },
+
+	{ TACHOMETER, "OBROTOMIERZ" },
+	{ EXTERIOR_FOV, "POLE WIDZENIA (ZEWN.)" },
+	{ INTERIOR_FOV, "POLE WIDZENIA (WEWN.)" },
+
+	{ GRAPHICS_PROFILE, "PROFIL GRAFIKI" },
+	{ GRAPHICS_PROFILE_CUSTOM, "W\xA3" "ASNY" },
+};
+
+static constexpr StringPackEntry ENGLISH_STRINGS[] = {
+	{ 994, "NA" },
+	{ 1004, "RETURN" }, { 1005, "ESC" }, { 1006, "BACKSPC" }, { 1007, "TAB" },
+	{ 1020, "PRINTSCRN" }, { 1021, "SCROLLLOCK" }, { 1022, "PAUSE" }, { 1023, "INSERT" },
+	{ 1024, "HOME" }, { 1025, "PGUP" }, { 1026, "DEL" }, { 1027, "END" },
+	{ 1028, "PGDN" }, { 1029, "RIGHT" }, { 1030, "LEFT" }, { 1031, "UP" },
+	{ 1032, "DOWN" },
+
+	{ RETURN_TO_CENTRE, "RETURN TO CENTRE" },
+
+	{ CODRIVER_POLISH_A, "POLISH (J. KULIG)" },
+	{ CODRIVER_POLISH_B, "POLISH (J. WITUCH)" },
+	{ CODRIVER_CZECH, "CZECH" },
+
+	{ DISPLAY_MODE, "DISPLAY MODE" },
+	{ FULLSCREEN, "FULLSCREEN" },
+	{ WINDOWED, "WINDOWED" },
+	{ BORDERLESS, "BORDERLESS" },
+	{ REFRESH_RATE, "REFRESH RATE" },
+	{ VSYNC, "VSYNC" },
+	{ ANISOTROPIC, "ANISOTROPIC FILTERING" },
+
+	{ TACHOMETER, "TACHOMETER" },
+	{ EXTERIOR_FOV, "FIELD OF VIEW (CHASE)" },
+	{ INTERIOR_FOV, "FIELD OF VIEW (INTERIOR)" },
+
+	{ GRAPHICS_PROFILE, "GRAPHICS PROFILE" },
+	{ GRAPHICS_PROFILE_CUSTOM, "CUSTOM" },
+};
+
+// Indexed by TEXT_LANG_*
+static constexpr StringPack STRING_PACKS[] = {
+	ENGLISH_STRINGS, // English
+	ENGLISH_STRINGS, // French
+	ENGLISH_STRINGS, // Spanish
+	ENGLISH_STRINGS, // German
+	ENGLISH_STRINGS, // Italian
+	POLISH_STRINGS, // Polish
+	ENGLISH_STRINGS, // Czech
+};
+
+static uint32_t GetTextLanguage()
+{
+	// Language_GetString can be patched in without GameInfo, so fall back to the executable language then
+	if (GameInfo_GetTextLanguage != nullptr)
+	{
+		return GameInfo_GetTextLanguage_LocalePackCheck();
+	}
+	return Version::IsPolish() ? TEXT_LANG_POLISH : TEXT_LANG_ENGLISH;
+}
+
+static const StringPack& GetStringPack(uint32_t langID)
+{
+	return STRING_PACKS[langID < std::size(STRING_PACKS) ? langID : TEXT_LANG_ENGLISH];
+}
+
+static void ApplyOverrideStrings(std::vector<const char*>& table, uint32_t numFiles)
+{
+	auto overrideString = [&table, numFiles](uint32_t ID, const char* text)
+	{
+		if (ID < numFiles)
+		{
+			table[ID] = text;
+		}
+	};
 
 	if (!Version::HasMultipleCoDrivers() && Version::HasJanuszWituchVoiceLines())
 	{
-		result.emplace(447, "JANUSZ WITUCH");
+		overrideString(447, "JANUSZ WITUCH");
 	}
 
 	if (!Version::HasMultipleLocales())
 	{
 		if (Version::IsPolish())
 		{
-			result.emplace(802, BONUSCODES_URL);
+			overrideString(802, BONUSCODES_URL);
 		}
 
 		if (Version::IsCzech())
 		{
 			// Original Czech string for "NA" is broken, as it was unused before
-			result.emplace(994, "ND");
+			overrideString(994, "ND");
 		}
 	}
-
-	return result;
 }
 
-static std::map<uint32_t, const char*> GetNewStrings()
+// Sanity checks the in-memory LangFile, so a damaged or mismatched Whole_X.Lng doesn't take the string table down with it
+static bool IsValidLangFile(const LangFile* language)
 {
-	std::map<uint32_t, const char*> result = {
-		{ LANGUAGE_POLISH, "POLSKI" },
-		{ LANGUAGE_CZECH, "\xC3" "ESKY" },
+	// No retail language file comes anywhere near this
+	static constexpr uint32_t MAX_STRINGS = 0x10000;
 
-		{ 1008, "F1" }, { 1009, "F2" }, { 1010, "F3" }, { 1011, "F4" },
-		{ 1012, "F5" }, { 1013, "F6" }, { 1014, "F7" }, { 1015, "F8" },
-		{ 1016, "F9" }, { 1017, "F10" }, { 1018, "F11" }, { 1019, "F12" },
+	if (language == nullptr || memcmp(language->m_magic, "LANG", sizeof(language->m_magic)) != 0 || language->m_numFiles >= MAX_STRINGS)
+	{
+		return false;
+	}
 
-		{ 1033, "[?]" },
-	};
+	return std::none_of(language->m_texts, language->m_texts + language->m_numFiles, [](const char* text) { return text == nullptr; });
+}
+
+// Flat table of all strings for the current language, indexed by string ID
+// Merges LangFile texts, overrides and SP strings, so lookups are a bounds check and a load
+static std::vector<const char*> gStringTable;
+static const LangFile* gStringTableLanguage = nullptr;
+static std::optional<uint32_t> gStringTableTextLanguage; // Picks the SP string pack, can change without the LangFile changing
+static uint32_t gStringTableVersion = 0;
+
+static void BuildStringTable(const LangFile* language, uint32_t textLanguage)
+{
+	const StringPack& stringPack = GetStringPack(textLanguage);
+
+	const uint32_t numFiles = IsValidLangFile(language) ? language->m_numFiles : 0;
+	uint32_t numStrings = numFiles;
+	for (const StringPack& pack : { StringPack(COMMON_STRINGS), stringPack })
+	{
+		for (const StringPackEntry& entry : pack)
+		{
+			numStrings = std::max(numStrings, entry.m_ID + 1);
+		}
+	}
 
-	if (Version::IsPolish())
+	gStringTable.assign(numStrings, "");
+	if (numFiles != 0)
 	{
-		result.merge(std::map<uint32_t, const char*> {
-			{ 994, "ND" },
-			{ 1004, "ENTER" }, { 1005, "ESC" }, { 1006, "BACKSPACE" }, { 1007, "TAB" },
-			{ 1020, "PRINTSCREEN" }, { 1021, "SCROLLLOCK" }, { 1022, "PAUZA" }, { 1023, "INSERT" },
-			{ 1024, "HOME" }, { 1025, "PGUP" }, { 1026, "DELETE" }, { 1027, "END" },
-			{ 1028, "PGDN" }, { 1029, "PRAWO" }, { 1030, "LEWO" }, { 1031, "G\xD3RA" },
-			{ 1032, "D\xD3\xA3" },
-
-			{ RETURN_TO_CENTRE, "POWR\xD3T DO POZ. NEUTRALNEJ" },
-
-			{ CODRIVER_POLISH_A, "JANUSZ KULIG" },
-			{ CODRIVER_POLISH_B, "JANUSZ WITUCH" },
-			{ CODRIVER_CZECH, "CZESKI" },
-
-			{ DISPLAY_MODE, "TRYB WY\x8CWIETLANIA" },
-			{ FULLSCREEN, "PE\xA3NY EKRAN" },
-			{ WINDOWED, "W OKNIE" },
-			{ BORDERLESS, "BEZ RAMKI" },
-			{ REFRESH_RATE, "CZ\xCAST. OD\x8CWIE\xAF" "ANIA" },
-			{ VSYNC, "SYNCHRONIZACJA PION." },
-			{ ANISOTROPIC, "FILTROWANIE ANIZOTROPOWE" },
-
-			{ TACHOMETER, "OBROTOMIERZ" },
-			{ EXTERIOR_FOV, "POLE WIDZENIA (ZEWN.)" },
-			{ INTERIOR_FOV, "POLE WIDZENIA (WEWN.)" },
-		});
+		std::copy_n(language->m_texts, numFiles, gStringTable.begin());
 	}
-	else
+	ApplyOverrideStrings(gStringTable, numFiles);
+
+	// New strings never shadow the strings from the language file
+	for (const StringPack& pack : { StringPack(COMMON_STRINGS), stringPack })
 	{
-		result.merge(std::map<uint32_t, const char*> {
-			{ 994, "NA" },
-			{ 1004, "RETURN" }, { 1005, "ESC" }, { 1006, "BACKSPC" }, { 1007, "TAB" },
-			{ 1020, "PRINTSCRN" }, { 1021, "SCROLLLOCK" }, { 1022, "PAUSE" }, { 1023, "INSERT" },
-			{ 1024, "HOME" }, { 1025, "PGUP" }, { 1026, "DEL" }, { 1027, "END" },
-			{ 1028, "PGDN" }, { 1029, "RIGHT" }, { 1030, "LEFT" }, { 1031, "UP" },
-			{ 1032, "DOWN" },
-
-			{ RETURN_TO_CENTRE, "RETURN TO CENTRE" },
-
-			{ CODRIVER_POLISH_A, "POLISH (J. KULIG)" },
-			{ CODRIVER_POLISH_B, "POLISH (J. WITUCH)" },
-			{ CODRIVER_CZECH, "CZECH" },
-
-			{ DISPLAY_MODE, "DISPLAY MODE" },
-			{ FULLSCREEN, "FULLSCREEN" },
-			{ WINDOWED, "WINDOWED" },
-			{ BORDERLESS, "BORDERLESS" },
-			{ REFRESH_RATE, "REFRESH RATE" },
-			{ VSYNC, "VSYNC" },
-			{ ANISOTROPIC, "ANISOTROPIC FILTERING" },
-
-			{ TACHOMETER, "TACHOMETER" },
-			{ EXTERIOR_FOV, "FIELD OF VIEW (CHASE)" },
-			{ INTERIOR_FOV, "FIELD OF VIEW (INTERIOR)" },
-		});
+		for (const StringPackEntry& entry : pack)
+		{
+			if (entry.m_ID >= numFiles)
+			{
+				gStringTable[entry.m_ID] = entry.m_text;
+			}
+		}
 	}
 
-	return result;
+	gStringTableLanguage = language;
+	gStringTableTextLanguage = textLanguage;
+	gStringTableVersion++;
 }
 
-const char* Language_GetString(uint32_t ID)
+static void UpdateStringTable()
 {
-	// Original code with bounds check added
 	const LangFile* language = *gpCurrentLanguage;
-	if (ID < language->m_numFiles)
+	const uint32_t textLanguage = GetTextLanguage();
+	if (language != gStringTableLanguage || textLanguage != gStringTableTextLanguage)
 	{
-		static const std::map<uint32_t, const char*> overrideStrings = GetOverrideStrings();
-		auto it = overrideStrings.find(ID);
-		if (it != overrideStrings.end())
-		{
-			return it->second;
-		}
-		return language->m_texts[ID];
+		BuildStringTable(language, textLanguage);
 	}
+}
 
-	// All strings that were hardcoded in the English release, but translated in the Polish release
-	// + new strings for options
-	static const std::map<uint32_t, const char*> newLocalizedStrings = GetNewStrings();
-	auto it = newLocalizedStrings.find(ID);
-	if (it != newLocalizedStrings.end())
-	{
-		return it->second;
-	}
+uint32_t Language_GetStringTableVersion()
+{
+	UpdateStringTable();
+	return gStringTableVersion;
+}
 
-	return "";
+const char* Language_GetString(uint32_t ID)
+{
+	UpdateStringTable();
+	return ID < gStringTable.size() ? gStringTable[ID] : "";
 }
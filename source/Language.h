@@ -30,8 +30,14 @@ namespace Language
 	static constexpr uint32_t TACHOMETER = FIRST_SP_STRING+13;
 	static constexpr uint32_t EXTERIOR_FOV = FIRST_SP_STRING+14;
 	static constexpr uint32_t INTERIOR_FOV = FIRST_SP_STRING+15;
+
+	static constexpr uint32_t GRAPHICS_PROFILE = FIRST_SP_STRING+16;
+	static constexpr uint32_t GRAPHICS_PROFILE_CUSTOM = FIRST_SP_STRING+17;
 }
 
 const char* Language_GetString(uint32_t ID);
 
+// Changes every time the current language changes, so anything derived from localized strings can be invalidated
+uint32_t Language_GetStringTableVersion();
+
 inline LangFile** gpCurrentLanguage;
@@ -6,7 +6,10 @@
 #include "Registry.h"
 #include "Version.h"
 
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <vector>
 
 static int32_t GetResolutionEntryFormatID(const MenuResolutionEntry* entry)
 {
@@ -105,6 +108,184 @@ void CMR_FE_SetDigitalTacho(bool digital)
 	Registry::SetRegistryDword(Registry::GRAPHICS_SECTION_NAME, Registry::DIGITAL_TACHO_KEY_NAME, digital ? 1 : 0);
 }
 
+// Named graphics profiles, stored as [Profile1], [Profile2]... in the INI
+// Every key in a profile is optional, missing keys leave the current setting as-is
+struct GraphicsProfile
+{
+	std::string m_name;
+
+	// Cheap - applied without a device reset
+	std::optional<uint32_t> m_exteriorFOV;
+	std::optional<uint32_t> m_interiorFOV;
+	std::optional<uint32_t> m_verticalSplitscreen;
+	std::optional<uint32_t> m_digitalTacho;
+	std::optional<uint32_t> m_anisotropic;
+
+	// Need Graphics_Change and a device reset
+	std::optional<uint32_t> m_width;
+	std::optional<uint32_t> m_height;
+	std::optional<uint32_t> m_displayMode;
+	std::optional<uint32_t> m_refreshRate;
+	std::optional<uint32_t> m_vsync;
+};
+
+static constexpr uint32_t MAX_GRAPHICS_PROFILES = 9;
+static std::vector<GraphicsProfile> gGraphicsProfiles;
+
+static void LoadGraphicsProfiles()
+{
+	using namespace Registry;
+
+	gGraphicsProfiles.clear();
+	for (uint32_t i = 1; i <= MAX_GRAPHICS_PROFILES; i++)
+	{
+		const std::wstring section = PROFILE_SECTION_PREFIX + std::to_wstring(i);
+		std::optional<std::string> name = GetRegistryString(section.c_str(), PROFILE_NAME_KEY_NAME);
+		if (!name)
+		{
+			break;
+		}
+
+		// Frontend fonts have no lowercase letters
+		std::transform(name->begin(), name->end(), name->begin(), [](char c) { return static_cast<char>(toupper(static_cast<unsigned char>(c))); });
+
+		GraphicsProfile& profile = gGraphicsProfiles.emplace_back();
+		profile.m_name = std::move(*name);
+		profile.m_exteriorFOV = GetRegistryDword(section.c_str(), EXTERIOR_FOV_KEY_NAME);
+		profile.m_interiorFOV = GetRegistryDword(section.c_str(), INTERIOR_FOV_KEY_NAME);
+		profile.m_verticalSplitscreen = GetRegistryDword(section.c_str(), SPLIT_SCREEN_KEY_NAME);
+		profile.m_digitalTacho = GetRegistryDword(section.c_str(), DIGITAL_TACHO_KEY_NAME);
+		profile.m_anisotropic = GetRegistryDword(section.c_str(), ANISOTROPIC_KEY_NAME);
+
+		profile.m_width = GetRegistryDword(section.c_str(), L"WIDTH");
+		profile.m_height = GetRegistryDword(section.c_str(), L"HEIGHT");
+		profile.m_displayMode = GetRegistryDword(section.c_str(), DISPLAY_MODE_KEY_NAME);
+		profile.m_refreshRate = GetRegistryDword(section.c_str(), REFRESH_RATE_KEY_NAME);
+		profile.m_vsync = GetRegistryDword(section.c_str(), VSYNC_KEY_NAME);
+	}
+}
+
+static int GetMaxAnisotropicIndex(int adapter)
+{
+	const int maxAF = CMR_FE_GetMaxAnisotropicLevel(adapter);
+	return maxAF >= 2 ? static_cast<int>(log2(maxAF)) : 0;
+}
+
+static uint32_t GetBitDepthIndex(D3DFORMAT format)
+{
+	switch (format)
+	{
+	case D3DFMT_R8G8B8:
+		return 1;
+	case D3DFMT_A8R8G8B8:
+	case D3DFMT_X8R8G8B8:
+		return 2;
+	case D3DFMT_R5G6B5:
+	case D3DFMT_X1R5G5B5:
+	case D3DFMT_A1R5G5B5:
+	case D3DFMT_A4R4G4B4:
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+// Profile picked in the Graphics menu whose device settings still have to be accepted in the Advanced Graphics menu, 0 if none
+static uint32_t gPendingGraphicsProfile = 0;
+
+static void ApplyGraphicsProfile(uint32_t profileID)
+{
+	using namespace Registry;
+
+	const GraphicsProfile& profile = gGraphicsProfiles[profileID - 1];
+	gPendingGraphicsProfile = 0;
+
+	// AF is re-applied to all samplers every frame, so it can change on the fly
+	if (profile.m_anisotropic)
+	{
+		const uint32_t level = std::min(*profile.m_anisotropic, static_cast<uint32_t>(GetMaxAnisotropicIndex(Graphics_GetCurrentConfig().m_adapter)));
+		CMR_FE_SetAnisotropicLevel(level);
+		SetRegistryDword(REGISTRY_SECTION_NAME, ANISOTROPIC_KEY_NAME, level);
+	}
+
+	// Device settings go through the Advanced Graphics menu options, so they need its patches
+	if (!Menus::Patches::ExtraAdvancedGraphicsOptionsPatched)
+	{
+		return;
+	}
+
+	const Graphics_Config& currentConfig = Graphics_GetCurrentConfig();
+	Graphics_Config profileConfig = currentConfig;
+	if (profile.m_width) profileConfig.m_resWidth = *profile.m_width;
+	if (profile.m_height) profileConfig.m_resHeight = *profile.m_height;
+	if (profile.m_refreshRate) profileConfig.m_refreshRate = *profile.m_refreshRate;
+	if (profile.m_displayMode)
+	{
+		profileConfig.m_windowed = *profile.m_displayMode != 0;
+		profileConfig.m_borderless = *profile.m_displayMode == 2;
+	}
+	if (profile.m_vsync) profileConfig.m_presentationInterval = *profile.m_vsync != 0 ? D3DPRESENT_INTERVAL_ONE : D3DPRESENT_INTERVAL_IMMEDIATE;
+
+	// Profiles sharing the device settings switch without a reset
+	if (!Graphics_Config_RequiresDeviceReset(currentConfig, profileConfig))
+	{
+		if (profile.m_anisotropic)
+		{
+			gmoFrontEndMenus[MenuID::GRAPHICS_ADVANCED].m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_value = CMR_FE_GetAnisotropicLevel();
+		}
+		return;
+	}
+
+	// Others are only staged for the Advanced Graphics menu and nothing is written to the INI yet
+	// Accepting them there goes through the keep-settings countdown, so a mode the monitor can't show reverts itself
+	gPendingGraphicsProfile = profileID;
+}
+
+// Loads the device settings of a profile into the Advanced Graphics menu values, as if the user picked them by hand
+static void StageGraphicsProfileDeviceSettings(MenuDefinition* menu, const GraphicsProfile& profile)
+{
+	using namespace EntryID;
+
+	const int32_t adapter = menu->m_entries[GRAPHICS_ADV_DRIVER].m_value;
+	const MenuResolutionEntry* resolutionEntry = GetMenuResolutionEntry(adapter, menu->m_entries[GRAPHICS_ADV_RESOLUTION].m_value);
+	const uint32_t currentRefreshRate = CMR_GetRefreshRateFromIndex(resolutionEntry, menu->m_entries[GRAPHICS_ADV_REFRESHRATE].m_value);
+
+	if (profile.m_width && profile.m_height)
+	{
+		// Only take the mode if the adapter has exactly that resolution
+		const int32_t modeIndex = CMR_GetValidModeIndex(adapter, *profile.m_width, *profile.m_height, GetBitDepthIndex(Graphics_GetCurrentConfig().m_format));
+		const MenuResolutionEntry* profileEntry = GetMenuResolutionEntry(adapter, modeIndex);
+		if (profileEntry != nullptr && profileEntry->m_width == static_cast<int>(*profile.m_width) && profileEntry->m_height == static_cast<int>(*profile.m_height))
+		{
+			menu->m_entries[GRAPHICS_ADV_RESOLUTION].m_value = modeIndex;
+			resolutionEntry = profileEntry;
+		}
+	}
+
+	// Refresh rates are indexed per mode, so re-resolve the current one if the profile doesn't have it
+	menu->m_entries[GRAPHICS_ADV_REFRESHRATE].m_value = CMR_GetRefreshRateIndex(resolutionEntry, profile.m_refreshRate.value_or(currentRefreshRate));
+	menu->m_entries[GRAPHICS_ADV_REFRESHRATE].m_entryDataInt = CMR_GetNumRefreshRates(resolutionEntry);
+
+	if (profile.m_displayMode) menu->m_entries[GRAPHICS_ADV_DISPLAYMODE].m_value = std::min(*profile.m_displayMode, 2u);
+	if (profile.m_vsync) menu->m_entries[GRAPHICS_ADV_VSYNC].m_value = *profile.m_vsync != 0;
+}
+
+uint32_t CMR_FE_GetNumGraphicsProfiles()
+{
+	return static_cast<uint32_t>(gGraphicsProfiles.size());
+}
+
+uint32_t CMR_FE_GetGraphicsProfile()
+{
+	const uint32_t profile = Registry::GetRegistryDword(Registry::GRAPHICS_SECTION_NAME, Registry::PROFILE_KEY_NAME).value_or(0);
+	return profile <= gGraphicsProfiles.size() ? profile : 0;
+}
+
+void CMR_FE_SetGraphicsProfile(uint32_t profile)
+{
+	Registry::SetRegistryDword(Registry::GRAPHICS_SECTION_NAME, Registry::PROFILE_KEY_NAME, profile);
+}
+
 void DrawLeftRightArrows_RightAlign(MenuDefinition* menu, uint32_t entryID, float interp, int leftArrow, int rightArrow, uint32_t posY)
 {
 	const float scaledWidth = GetScaledResolutionWidth();
@@ -147,11 +328,13 @@ void FrontEndMenuSystem_SetupMenus_Custom(int languagesOnly)
 	// Extended Graphics screen
 	if (Menus::Patches::ExtraGraphicsOptionsPatched)
 	{
+		LoadGraphicsProfiles();
+
 		auto& menu = gmoFrontEndMenus[MenuID::GRAPHICS];
 		{
-			// Make space for FOV control
+			// Make space for FOV control and profiles
 			auto* optSource = &menu.m_entries[4];
-			auto* optDest = optSource + 4;
+			auto* optDest = optSource + 5;
 			memmove(optDest, optSource, 2 * sizeof(*optSource));
 		}
 
@@ -176,6 +359,16 @@ void FrontEndMenuSystem_SetupMenus_Custom(int languagesOnly)
 		menu.m_entries[EntryID::GRAPHICS_INTERIOR_FOV].m_entryDataString = nullptr;
 		menu.m_entries[EntryID::GRAPHICS_INTERIOR_FOV].m_entryDataInt = FOV_NUM_VALUES;
 
+		memcpy(&menu.m_entries[EntryID::GRAPHICS_PROFILE], &menu.m_entries[2], sizeof(menu.m_entries[2]));
+		menu.m_entries[EntryID::GRAPHICS_PROFILE].m_stringID = Language::GRAPHICS_PROFILE;
+		menu.m_entries[EntryID::GRAPHICS_PROFILE].m_entryDataString = nullptr;
+		menu.m_entries[EntryID::GRAPHICS_PROFILE].m_entryDataInt = 1 + CMR_FE_GetNumGraphicsProfiles();
+		if (CMR_FE_GetNumGraphicsProfiles() == 0)
+		{
+			menu.m_entries[EntryID::GRAPHICS_PROFILE].m_canBeSelected = 0;
+			menu.m_entries[EntryID::GRAPHICS_PROFILE].m_isDisplayed = 0;
+		}
+
 		menu.m_numEntries = EntryID::GRAPHICS_NUM;
 	}
 
@@ -289,26 +482,7 @@ void PC_GraphicsAdvanced_LoadSettings()
 	const Graphics_Config& config = Graphics_GetCurrentConfig();
 	Graphics_CheckForVertexShaders(config.m_adapter, 0, 1);
 
-	uint32_t BitDepth;
-	switch (config.m_format)
-	{
-	case D3DFMT_R8G8B8:
-		BitDepth = 1;
-		break;
-	case D3DFMT_A8R8G8B8:
-	case D3DFMT_X8R8G8B8:
-		BitDepth = 2;
-		break;
-	case D3DFMT_R5G6B5:
-	case D3DFMT_X1R5G5B5:
-	case D3DFMT_A1R5G5B5:
-	case D3DFMT_A4R4G4B4:
-		BitDepth = 0;
-		break;
-	default:
-		BitDepth = 0;
-		break;
-	}
+	const uint32_t BitDepth = GetBitDepthIndex(config.m_format);
 
 	using namespace EntryID;
 	auto& menu = gmoFrontEndMenus[MenuID::GRAPHICS_ADVANCED];
@@ -323,7 +497,8 @@ void PC_GraphicsAdvanced_LoadSettings()
 	menu.m_entries[GRAPHICS_ADV_DISPLAYMODE].m_value = Registry::GetRegistryDword(Registry::REGISTRY_SECTION_NAME, Registry::DISPLAY_MODE_KEY_NAME).value_or(0);
 	menu.m_entries[GRAPHICS_ADV_REFRESHRATE].m_value = CMR_GetRefreshRateIndex(resolutionEntry, Registry::GetRegistryDword(Registry::REGISTRY_SECTION_NAME, Registry::REFRESH_RATE_KEY_NAME).value_or(0));
 	menu.m_entries[GRAPHICS_ADV_VSYNC].m_value = Registry::GetRegistryDword(Registry::REGISTRY_SECTION_NAME, Registry::VSYNC_KEY_NAME).value_or(1);
-	menu.m_entries[GRAPHICS_ADV_ANISOTROPIC].m_value = Registry::GetRegistryDword(Registry::REGISTRY_SECTION_NAME, Registry::ANISOTROPIC_KEY_NAME).value_or(0);
+	menu.m_entries[GRAPHICS_ADV_ANISOTROPIC].m_value = std::min(static_cast<int>(Registry::GetRegistryDword(Registry::REGISTRY_SECTION_NAME, Registry::ANISOTROPIC_KEY_NAME).value_or(0)),
+		GetMaxAnisotropicIndex(Adapter));
 
 	menu.m_entries[GRAPHICS_ADV_TEXTUREQUALITY].m_value = CMR_FE_GetTextureQuality();
 	menu.m_entries[GRAPHICS_ADV_ENVMAP].m_value = CMR_FE_GetEnvironmentMap();
@@ -395,6 +570,13 @@ void PC_GraphicsAdvanced_Enter_NewOptions(MenuDefinition* menu, int /*a2*/)
 	gSavedVSync = menu->m_entries[GRAPHICS_ADV_VSYNC].m_value;
 	gSavedRefreshRate = menu->m_entries[GRAPHICS_ADV_REFRESHRATE].m_value;
 	gSavedAF = menu->m_entries[GRAPHICS_ADV_ANISOTROPIC].m_value;
+
+	// Staged after taking the saved values, so accepting the profile counts as a change and resets the device
+	if (gPendingGraphicsProfile > 0 && gPendingGraphicsProfile <= gGraphicsProfiles.size())
+	{
+		StageGraphicsProfileDeviceSettings(menu, gGraphicsProfiles[gPendingGraphicsProfile - 1]);
+	}
+	gPendingGraphicsProfile = 0;
 }
 
 MenuDefinition* PC_GraphicsAdvanced_Select_NewOptions(MenuDefinition* menu, MenuEntry* entry)
@@ -424,17 +606,9 @@ MenuDefinition* PC_GraphicsAdvanced_Select_NewOptions(MenuDefinition* menu, Menu
 
 void PC_GraphicsAdvanced_PopulateFromCaps_NewOptions(MenuDefinition* menu, uint32_t currentAdapter, uint32_t /*newAdapter*/)
 {
-	const int maxAF = CMR_FE_GetMaxAnisotropicLevel(currentAdapter);
-	if (maxAF >= 2)
-	{
-		menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_entryDataInt = 1 + static_cast<int>(log2(maxAF));
-		menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_canBeSelected = 1;
-	}
-	else
-	{
-		menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_entryDataInt = 1;
-		menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_canBeSelected = 0;
-	}
+	const int maxAFIndex = GetMaxAnisotropicIndex(currentAdapter);
+	menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_entryDataInt = 1 + maxAFIndex;
+	menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_canBeSelected = maxAFIndex > 0 ? 1 : 0;
 }
 
 static void Menus_DisplayOnOff(MenuDefinition* menu, const char* optionText, const char* offText, const char* onText, uint32_t entryID, int value, uint32_t offColor, uint32_t onColor, float interp, bool displayBoth, bool swapColors = false);
@@ -450,10 +624,10 @@ void PC_GraphicsAdvanced_Display_NewOptions(MenuDefinition* menu, float interp,
 
 		const uint32_t stringsByOption[] = { Language::FULLSCREEN, Language::WINDOWED, Language::BORDERLESS };
 		target += sprintf_s(target, targetEnd - target, "%s: ", Language_GetString(Language::DISPLAY_MODE));
-		const int leftArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int leftArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		target += sprintf_s(target, targetEnd - target, " %s ", Language_GetString(stringsByOption[menu->m_entries[EntryID::GRAPHICS_ADV_DISPLAYMODE].m_value]));
-		const int rightArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int rightArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		DrawLeftRightArrows_RightAlign(menu, entryID, interp, leftArrowTextLength + 393, rightArrowTextLength + 393, posY);
 		break;
@@ -464,14 +638,14 @@ void PC_GraphicsAdvanced_Display_NewOptions(MenuDefinition* menu, float interp,
 		char* const targetEnd = target+512;
 
 		target += sprintf_s(target, targetEnd - target, "%s: ", Language_GetString(Language::REFRESH_RATE));
-		const int leftArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int leftArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		uint32_t refreshRate = CMR_GetRefreshRateFromIndex(GetMenuResolutionEntry(
 			menu->m_entries[EntryID::GRAPHICS_ADV_DRIVER].m_value, menu->m_entries[EntryID::GRAPHICS_ADV_RESOLUTION].m_value),
 			menu->m_entries[EntryID::GRAPHICS_ADV_REFRESHRATE].m_value);
 		
 		target += sprintf_s(target, targetEnd - target, " %uHZ ", refreshRate);
-		const int rightArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int rightArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		DrawLeftRightArrows_RightAlign(menu, entryID, interp, leftArrowTextLength + 393, rightArrowTextLength + 393, posY);
 		break;
@@ -489,7 +663,7 @@ void PC_GraphicsAdvanced_Display_NewOptions(MenuDefinition* menu, float interp,
 		char* const targetEnd = target+512;
 
 		target += sprintf_s(target, targetEnd - target, "%s: ", Language_GetString(Language::ANISOTROPIC));
-		const int leftArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int leftArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		const int afValue = menu->m_entries[EntryID::GRAPHICS_ADV_ANISOTROPIC].m_value;
 		if (afValue > 0)
@@ -500,7 +674,7 @@ void PC_GraphicsAdvanced_Display_NewOptions(MenuDefinition* menu, float interp,
 		{
 			target += sprintf_s(target, targetEnd - target, " %s ", Language_GetString(85));
 		}
-		const int rightArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int rightArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		DrawLeftRightArrows_RightAlign(menu, entryID, interp, leftArrowTextLength + 393, rightArrowTextLength + 393, posY);
 		break;
@@ -512,7 +686,7 @@ void PC_GraphicsAdvanced_Display_NewOptions(MenuDefinition* menu, float interp,
 
 static void Menus_DisplayOnOff(MenuDefinition* /*menu*/, const char* optionText, const char* offText, const char* onText, uint32_t posY, int value, uint32_t offColor, uint32_t onColor, float interp, bool displayBoth, bool swapColors)
 {
-	int currentPosX = CMR3Font_GetTextWidth(0, optionText) + 393;
+	int currentPosX = CMR3Font_GetTextWidth_Cached(0, optionText) + 393;
 	if (swapColors && value == 0)
 	{
 		std::swap(offColor, onColor);
@@ -523,7 +697,7 @@ static void Menus_DisplayOnOff(MenuDefinition* /*menu*/, const char* optionText,
 	if (displayBoth || value == 0)
 	{
 		CMR3Font_BlitText_RightAlign(0, buf, static_cast<int16_t>(currentPosX), static_cast<int16_t>(posY), HandyFunction_AlphaCombineFlat(offColor, static_cast<uint32_t>(interp * interp * 255.0f)), 9);
-		currentPosX += CMR3Font_GetTextWidth(0, buf);
+		currentPosX += CMR3Font_GetTextWidth_Cached(0, buf);
 	}
 
 	if (displayBoth || value != 0)
@@ -533,6 +707,39 @@ static void Menus_DisplayOnOff(MenuDefinition* /*menu*/, const char* optionText,
 	}
 }
 
+// Graphics menu values as they were on entering the menu
+struct GraphicsOptionsSnapshot
+{
+	int m_profile;
+	int m_splitScreen;
+	int m_tacho;
+	int m_exteriorFOV;
+	int m_interiorFOV;
+};
+static GraphicsOptionsSnapshot gSavedGraphicsOptions;
+
+// A newly picked profile overrides the settings it specifies, unless they were also changed by hand in this visit
+static void ApplyGraphicsProfileToMenu(MenuDefinition* menu, const GraphicsProfile& profile)
+{
+	auto fovToValue = [](uint32_t FOV)
+	{
+		return (std::clamp(static_cast<int>(FOV), FOV_MIN, FOV_MAX) - FOV_MIN) / FOV_STEP;
+	};
+	auto applyIfUnchanged = [menu](size_t entryID, int savedValue, int profileValue)
+	{
+		int& value = menu->m_entries[entryID].m_value;
+		if (value == savedValue)
+		{
+			value = profileValue;
+		}
+	};
+
+	if (profile.m_exteriorFOV) applyIfUnchanged(EntryID::GRAPHICS_EXTERIOR_FOV, gSavedGraphicsOptions.m_exteriorFOV, fovToValue(*profile.m_exteriorFOV));
+	if (profile.m_interiorFOV) applyIfUnchanged(EntryID::GRAPHICS_INTERIOR_FOV, gSavedGraphicsOptions.m_interiorFOV, fovToValue(*profile.m_interiorFOV));
+	if (profile.m_verticalSplitscreen) applyIfUnchanged(EntryID::GRAPHICS_SPLIT_SCREEN, gSavedGraphicsOptions.m_splitScreen, *profile.m_verticalSplitscreen != 0);
+	if (profile.m_digitalTacho) applyIfUnchanged(EntryID::GRAPHICS_TACHO, gSavedGraphicsOptions.m_tacho, *profile.m_digitalTacho != 0);
+}
+
 void PC_GraphicsOptions_Display_NewOptions(MenuDefinition* menu, float interp, uint32_t posY, uint32_t entryID, uint32_t offColor, uint32_t onColor)
 {
 	switch (entryID)
@@ -558,9 +765,24 @@ void PC_GraphicsOptions_Display_NewOptions(MenuDefinition* menu, float interp, u
 		char* const targetEnd = target+512;
 
 		target += sprintf_s(target, targetEnd - target, "%s: ", Language_GetString(menu->m_entries[entryID].m_stringID));
-		const int leftArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int leftArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 		target += sprintf_s(target, targetEnd - target, " %d ", FOV_MIN + menu->m_entries[entryID].m_value * FOV_STEP);
-		const int rightArrowTextLength = CMR3Font_GetTextWidth(0, gszTempString);
+		const int rightArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
+
+		DrawLeftRightArrows_RightAlign(menu, entryID, interp, leftArrowTextLength + 393, rightArrowTextLength + 393, posY);
+		break;
+	}
+	case EntryID::GRAPHICS_PROFILE:
+	{
+		const int profile = menu->m_entries[entryID].m_value;
+
+		char* target = gszTempString;
+		char* const targetEnd = target+512;
+
+		target += sprintf_s(target, targetEnd - target, "%s: ", Language_GetString(menu->m_entries[entryID].m_stringID));
+		const int leftArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
+		target += sprintf_s(target, targetEnd - target, " %s ", profile > 0 ? gGraphicsProfiles[profile - 1].m_name.c_str() : Language_GetString(Language::GRAPHICS_PROFILE_CUSTOM));
+		const int rightArrowTextLength = CMR3Font_GetTextWidth_Cached(0, gszTempString);
 
 		DrawLeftRightArrows_RightAlign(menu, entryID, interp, leftArrowTextLength + 393, rightArrowTextLength + 393, posY);
 		break;
@@ -576,12 +798,40 @@ void PC_GraphicsOptions_Enter_NewOptions(MenuDefinition* menu, int /*a2*/)
 	menu->m_entries[EntryID::GRAPHICS_SPLIT_SCREEN].m_value = CMR_FE_GetVerticalSplitscreen();
 	menu->m_entries[EntryID::GRAPHICS_EXTERIOR_FOV].m_value = (CMR_FE_GetExteriorFOV() - FOV_MIN) / FOV_STEP;
 	menu->m_entries[EntryID::GRAPHICS_INTERIOR_FOV].m_value = (CMR_FE_GetInteriorFOV() - FOV_MIN) / FOV_STEP;
+
+	menu->m_entries[EntryID::GRAPHICS_PROFILE].m_value = CMR_FE_GetGraphicsProfile();
+
+	gSavedGraphicsOptions.m_profile = menu->m_entries[EntryID::GRAPHICS_PROFILE].m_value;
+	gSavedGraphicsOptions.m_splitScreen = menu->m_entries[EntryID::GRAPHICS_SPLIT_SCREEN].m_value;
+	gSavedGraphicsOptions.m_tacho = menu->m_entries[EntryID::GRAPHICS_TACHO].m_value;
+	gSavedGraphicsOptions.m_exteriorFOV = menu->m_entries[EntryID::GRAPHICS_EXTERIOR_FOV].m_value;
+	gSavedGraphicsOptions.m_interiorFOV = menu->m_entries[EntryID::GRAPHICS_INTERIOR_FOV].m_value;
 }
 
 void PC_GraphicsOptions_Exit_NewOptions(MenuDefinition* menu, int /*a2*/)
 {
+	const int profile = menu->m_entries[EntryID::GRAPHICS_PROFILE].m_value;
+	const bool profileChanged = profile != gSavedGraphicsOptions.m_profile;
+	if (profileChanged && profile > 0)
+	{
+		ApplyGraphicsProfileToMenu(menu, gGraphicsProfiles[profile - 1]);
+	}
+
 	CMR_FE_SetDigitalTacho(menu->m_entries[EntryID::GRAPHICS_TACHO].m_value != 0);
 	CMR_FE_SetVerticalSplitscreen(menu->m_entries[EntryID::GRAPHICS_SPLIT_SCREEN].m_value != 0);
 	CMR_FE_SetExteriorFOV(FOV_MIN + menu->m_entries[EntryID::GRAPHICS_EXTERIOR_FOV].m_value * FOV_STEP);
 	CMR_FE_SetInteriorFOV(FOV_MIN + menu->m_entries[EntryID::GRAPHICS_INTERIOR_FOV].m_value * FOV_STEP);
+
+	if (profileChanged)
+	{
+		CMR_FE_SetGraphicsProfile(profile);
+		if (profile > 0)
+		{
+			ApplyGraphicsProfile(profile);
+		}
+		else
+		{
+			gPendingGraphicsProfile = 0;
+		}
+	}
 }
@@ -33,9 +33,10 @@ namespace EntryID
 	static constexpr size_t GRAPHICS_TACHO = 5; // NEW
 	static constexpr size_t GRAPHICS_EXTERIOR_FOV = 6; // NEW
 	static constexpr size_t GRAPHICS_INTERIOR_FOV = 7; // NEW
-	static constexpr size_t GRAPHICS_ACCEPT = 8; // Original - 4
-	static constexpr size_t GRAPHICS_BACK = 9; // Original - 5
-	static constexpr size_t GRAPHICS_NUM = 10; // Original - 6
+	static constexpr size_t GRAPHICS_PROFILE = 8; // NEW
+	static constexpr size_t GRAPHICS_ACCEPT = 9; // Original - 4
+	static constexpr size_t GRAPHICS_BACK = 10; // Original - 5
+	static constexpr size_t GRAPHICS_NUM = 11; // Original - 6
 }
 
 struct Packed_Registry
@@ -75,6 +76,10 @@ void CMR_FE_SetVerticalSplitscreen(bool vertical);
 bool CMR_FE_GetDigitalTacho();
 void CMR_FE_SetDigitalTacho(bool digital);
 
+uint32_t CMR_FE_GetNumGraphicsProfiles();
+uint32_t CMR_FE_GetGraphicsProfile();
+void CMR_FE_SetGraphicsProfile(uint32_t profile);
+
 inline void (*SetUseLowQualityTextures)(uint32_t);
 
 struct MenuDefinition;
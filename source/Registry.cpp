@@ -68,6 +68,24 @@ std::optional<char> Registry::GetRegistryChar(const wchar_t* section, const wcha
 	return result;
 }
 
+std::optional<std::string> Registry::GetRegistryString(const wchar_t* section, const wchar_t* key)
+{
+	std::optional<std::string> result;
+
+	wchar_t buf[64];
+	const DWORD length = GetPrivateProfileStringW(section, key, L"", buf, static_cast<DWORD>(std::size(buf)), pathToIni.c_str());
+	if (length != 0)
+	{
+		const int count = WideCharToMultiByte(CP_ACP, 0, buf, length, nullptr, 0, nullptr, nullptr);
+		if (count != 0)
+		{
+			std::string& str = result.emplace(count, '\0');
+			WideCharToMultiByte(CP_ACP, 0, buf, length, str.data(), count, nullptr, nullptr);
+		}
+	}
+	return result;
+}
+
 void Registry::SetRegistryDword(const wchar_t* section, const wchar_t* key, uint32_t value)
 {
 	WritePrivateProfileStringW(section, key, std::to_wstring(value).c_str(), pathToIni.c_str());
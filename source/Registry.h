@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <string>
 
 // Portability stuff
 namespace Registry
@@ -10,6 +11,11 @@ namespace Registry
 	inline const wchar_t* REGISTRY_SECTION_NAME = L"Registry";
 	inline const wchar_t* ADVANCED_SECTION_NAME = L"Advanced";
 
+	// Graphics profiles live in [Profile1], [Profile2] etc.
+	inline const wchar_t* PROFILE_SECTION_PREFIX = L"Profile";
+	inline const wchar_t* PROFILE_KEY_NAME = L"PROFILE";
+	inline const wchar_t* PROFILE_NAME_KEY_NAME = L"NAME";
+
 	inline const wchar_t* DISPLAY_MODE_KEY_NAME = L"DISPLAY_MODE";
 	inline const wchar_t* REFRESH_RATE_KEY_NAME = L"REFRESH_RATE";
 	inline const wchar_t* VSYNC_KEY_NAME = L"VSYNC";
@@ -34,6 +40,7 @@ namespace Registry
 
 	std::optional<uint32_t> GetRegistryDword(const wchar_t* section, const wchar_t* key);
 	std::optional<char> GetRegistryChar(const wchar_t* section, const wchar_t* key);
+	std::optional<std::string> GetRegistryString(const wchar_t* section, const wchar_t* key);
 
 	void SetRegistryDword(const wchar_t* section, const wchar_t* key, uint32_t value);
 	void SetRegistryChar(const wchar_t* section, const wchar_t* key, char value);
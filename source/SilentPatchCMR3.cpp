@@ -26,15 +26,20 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <map>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <DirectXMath.h>
+#include <intrin.h>
 
 #pragma comment(lib, "winmm.lib")
 
@@ -321,6 +326,7 @@ namespace Localization
 				{
 					FrontEndFonts_Destroy();
 					FrontEndFonts_Load();
+					CMR3Font_InvalidateTextWidths();
 				}
 				Cubes::SetUpCubeLayouts();
 				lastLangID = langID;
@@ -470,6 +476,64 @@ namespace Cubes
 	}
 }
 
+// Layouts of static text blocks, resolved once and replayed every frame with only the alpha changing
+// They are rebuilt on language or resolution change, so measured widths and looked up strings stay valid
+namespace TextLayouts
+{
+	class Layout
+	{
+	public:
+		// Any extra state the layout depends on can be passed as userKey
+		bool NeedsRebuild(uint32_t userKey = 0)
+		{
+			const auto key = std::make_tuple(Language_GetStringTableVersion(), GetScaledResolutionWidth(), userKey);
+			if (m_key == key)
+			{
+				return false;
+			}
+
+			m_key = key;
+			m_texts.clear();
+			m_strings.clear();
+			return true;
+		}
+
+		// For strings that don't outlive the build, like formatted numbers
+		const char* Store(std::string text)
+		{
+			return m_strings.emplace_back(std::move(text)).c_str();
+		}
+
+		void Add(uint8_t fontID, const char* text, int16_t posX, int16_t posY, uint32_t color, int align)
+		{
+			m_texts.push_back({text, color, align, posX, posY, fontID});
+		}
+
+		void Draw(uint32_t alpha) const
+		{
+			for (const Text& text : m_texts)
+			{
+				CMR3Font_BlitText(text.m_fontID, text.m_text, text.m_posX, text.m_posY, HandyFunction_AlphaCombineFlat(text.m_color, alpha), text.m_align);
+			}
+		}
+
+	private:
+		struct Text
+		{
+			const char* m_text;
+			uint32_t m_color;
+			int m_align;
+			int16_t m_posX;
+			int16_t m_posY;
+			uint8_t m_fontID;
+		};
+
+		std::optional<std::tuple<uint32_t, float, uint32_t>> m_key;
+		std::vector<Text> m_texts;
+		std::deque<std::string> m_strings; // deque keeps c_str() pointers stable
+	};
+}
+
 namespace SecretsScreen
 {
 	static const char gEnglishText[] = "CALLS COST \xA3" "1 PER MINUTE. ROI: CALLS COST 1.27 EUROS PER MINUTE INC. VAT. CALLS FROM MOBILES VARY. CALLERS MUST BE OVER 16 AND HAVE PERMISSION FROM THE BILL PAYER. PRICES CORRECT AT TIME OF GOING TO PRESS.     ";
@@ -505,11 +569,10 @@ namespace SecretsScreen
 	}
 
 	static int (*GetAccessCode)();
-	static void DrawSecretsScreen(uint8_t alpha)
+	static void BuildSecretsScreen(TextLayouts::Layout& layout, bool polishSecretsScreen, int accessCode)
 	{
-		const bool polishSecretsScreen = GameInfo_GetTextLanguage_LocalePackCheck() == TEXT_LANG_POLISH;
-		const uint32_t COLOR_WHITE = HandyFunction_AlphaCombineFlat(0xFFDCDCDC, alpha);
-		const uint32_t COLOR_YELLOW = HandyFunction_AlphaCombineFlat(0xFFDCDC14, alpha);
+		const uint32_t COLOR_WHITE = 0xFFDCDCDC;
+		const uint32_t COLOR_YELLOW = 0xFFDCDC14;
 
 		const int16_t SPACING_VERTICAL_SMALL = 17;
 		const int16_t SPACING_VERTICAL_BIG = 26;
@@ -522,33 +585,35 @@ namespace SecretsScreen
 			// Polish
 			int16_t posY = 60;
 
-			CMR3Font_BlitText(0, Language_GetString(796), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(796), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 			posY += SPACING_VERTICAL_SMALL;
 
-			CMR3Font_BlitText(0, BONUSCODES_URL, LEFT_MARGIN, posY, COLOR_YELLOW, 33);
+			layout.Add(0, BONUSCODES_URL, LEFT_MARGIN, posY, COLOR_YELLOW, 33);
 			posY += SPACING_VERTICAL_SMALL;
 			{
 				int16_t posX = LEFT_MARGIN;
-				CMR3Font_BlitText(0, Language_GetString(797), posX, posY, COLOR_WHITE, 33);
+				layout.Add(0, Language_GetString(797), posX, posY, COLOR_WHITE, 33);
 				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, Language_GetString(797)) + CMR3Font_GetTextWidth(0, " "));
 
-				sprintf_s(gszTempString, 512, "%.4d", GetAccessCode());
-				CMR3Font_BlitText(12, gszTempString, posX, posY + 2, COLOR_YELLOW, 33);
-				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, " ") + CMR3Font_GetTextWidth(12, gszTempString));
+				char accessCodeText[16];
+				sprintf_s(accessCodeText, "%.4d", accessCode);
+				const char* accessCodeString = layout.Store(accessCodeText);
+				layout.Add(12, accessCodeString, posX, static_cast<int16_t>(posY + 2), COLOR_YELLOW, 33);
+				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, " ") + CMR3Font_GetTextWidth(12, accessCodeString));
 
-				CMR3Font_BlitText(0, ".", posX, posY, COLOR_WHITE, 33);
+				layout.Add(0, ".", posX, posY, COLOR_WHITE, 33);
 			}
 			posY += SPACING_VERTICAL_SMALL;
-			CMR3Font_BlitText(0, Language_GetString(798), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(798), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 			posY += SPACING_VERTICAL_SMALL;
-			CMR3Font_BlitText(0, Language_GetString(799), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(799), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 			posY += SPACING_VERTICAL_SMALL;
-			CMR3Font_BlitText(0, Language_GetString(800), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(800), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 
 			posY = 248;
-			CMR3Font_BlitText(12, Language_GetString(803), centerPosX, posY, COLOR_WHITE, 10);
+			layout.Add(12, Language_GetString(803), centerPosX, posY, COLOR_WHITE, 10);
 			posY += SPACING_VERTICAL_BIG;
-			CMR3Font_BlitText(12, Language_GetString(801), centerPosX, posY, COLOR_WHITE, 10);
+			layout.Add(12, Language_GetString(801), centerPosX, posY, COLOR_WHITE, 10);
 		}
 		else
 		{
@@ -557,45 +622,60 @@ namespace SecretsScreen
 			// Top left
 			int16_t posY = 60;
 
-			CMR3Font_BlitText(0, Language_GetString(796), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(796), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 			posY += SPACING_VERTICAL_SMALL;
 			{
 				int16_t posX = LEFT_MARGIN;
-				CMR3Font_BlitText(0, Language_GetString(797), posX, posY, COLOR_WHITE, 33);
+				layout.Add(0, Language_GetString(797), posX, posY, COLOR_WHITE, 33);
 				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, Language_GetString(797)) + CMR3Font_GetTextWidth(0, " "));
 
-				sprintf_s(gszTempString, 512, "%.4d", GetAccessCode());
-				CMR3Font_BlitText(12, gszTempString, posX, posY + 2, COLOR_YELLOW, 33);
-				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, " ") + CMR3Font_GetTextWidth(12, gszTempString));
+				char accessCodeText[16];
+				sprintf_s(accessCodeText, "%.4d", accessCode);
+				const char* accessCodeString = layout.Store(accessCodeText);
+				layout.Add(12, accessCodeString, posX, static_cast<int16_t>(posY + 2), COLOR_YELLOW, 33);
+				posX += static_cast<int16_t>(CMR3Font_GetTextWidth(0, " ") + CMR3Font_GetTextWidth(12, accessCodeString));
 
-				CMR3Font_BlitText(0, ".", posX, posY, COLOR_WHITE, 33);
+				layout.Add(0, ".", posX, posY, COLOR_WHITE, 33);
 			}
 			posY += SPACING_VERTICAL_SMALL;
-			CMR3Font_BlitText(0, Language_GetString(798), LEFT_MARGIN, posY, COLOR_WHITE, 33);
+			layout.Add(0, Language_GetString(798), LEFT_MARGIN, posY, COLOR_WHITE, 33);
 
 			// Center
 			posY = 114;
 
-			CMR3Font_BlitText(12, Language_GetString(799), centerPosX, posY, COLOR_WHITE, 12);
-			CMR3Font_BlitText(12, " 09065 558898", centerPosX, posY, COLOR_WHITE, 9);
+			layout.Add(12, Language_GetString(799), centerPosX, posY, COLOR_WHITE, 12);
+			layout.Add(12, " 09065 558898", centerPosX, posY, COLOR_WHITE, 9);
 			posY += SPACING_VERTICAL_BIG;
 
-			CMR3Font_BlitText(12, Language_GetString(800), centerPosX, posY, COLOR_WHITE, 12);
-			CMR3Font_BlitText(12, " 1570 92 30 50", centerPosX, posY, COLOR_WHITE, 9);
+			layout.Add(12, Language_GetString(800), centerPosX, posY, COLOR_WHITE, 12);
+			layout.Add(12, " 1570 92 30 50", centerPosX, posY, COLOR_WHITE, 9);
 			posY += SPACING_VERTICAL_BIG;
 
-			CMR3Font_BlitText(12, Language_GetString(801), centerPosX, posY, COLOR_WHITE, 12);
-			CMR3Font_BlitText(12, " 08 92 69 33 77", centerPosX, posY, COLOR_WHITE, 9);
+			layout.Add(12, Language_GetString(801), centerPosX, posY, COLOR_WHITE, 12);
+			layout.Add(12, " 08 92 69 33 77", centerPosX, posY, COLOR_WHITE, 9);
 			posY += SPACING_VERTICAL_BIG;
 
-			CMR3Font_BlitText(12, Language_GetString(802), centerPosX, posY, COLOR_WHITE, 12);
-			CMR3Font_BlitText(12, " 0190 900 045", centerPosX, posY, COLOR_WHITE, 9);
+			layout.Add(12, Language_GetString(802), centerPosX, posY, COLOR_WHITE, 12);
+			layout.Add(12, " 0190 900 045", centerPosX, posY, COLOR_WHITE, 9);
 	
 			posY = 248;
-			CMR3Font_BlitText(12, Language_GetString(803), centerPosX, posY, COLOR_WHITE, 10);
+			layout.Add(12, Language_GetString(803), centerPosX, posY, COLOR_WHITE, 10);
 			posY += SPACING_VERTICAL_BIG;
-			CMR3Font_BlitText(12, BONUSCODES_URL, centerPosX, posY, COLOR_WHITE, 10);
+			layout.Add(12, BONUSCODES_URL, centerPosX, posY, COLOR_WHITE, 10);
+		}
+	}
+
+	static void DrawSecretsScreen(uint8_t alpha)
+	{
+		static TextLayouts::Layout layout;
+
+		const bool polishSecretsScreen = GameInfo_GetTextLanguage_LocalePackCheck() == TEXT_LANG_POLISH;
+		const int accessCode = GetAccessCode();
+		if (layout.NeedsRebuild(static_cast<uint32_t>(accessCode) << 1 | (polishSecretsScreen ? 1 : 0)))
+		{
+			BuildSecretsScreen(layout, polishSecretsScreen, accessCode);
 		}
+		layout.Draw(alpha);
 	}
 
 	static void CMR3Font_BlitText_NOP(uint8_t /*a1*/, const char* /*text*/, int16_t /*posX*/, int16_t /*posY*/, uint32_t /*color*/, int /*align*/)
@@ -843,6 +923,43 @@ namespace CappedResolutionCountdown
 	}
 }
 
+namespace FormattedStrings
+{
+	// Caches the last string formatted by a call site, so per-frame menu texts are only re-formatted
+	// when their inputs or the language change. String inputs are compared by contents.
+	template<size_t Size, typename... Args>
+	class Cache
+	{
+	public:
+		const char* Format(const char* format, Args... args)
+		{
+			const uint32_t version = Language_GetStringTableVersion();
+			if (m_length < 0 || m_version != version || m_key != std::tuple<const char*, Args...>(format, args...))
+			{
+				m_key = std::tuple<const char*, Args...>(format, args...);
+				m_length = sprintf_s(m_buffer, format, args...);
+				m_version = version;
+			}
+			return m_buffer;
+		}
+
+		int FormatTo(char* buffer, size_t size, const char* format, Args... args)
+		{
+			strcpy_s(buffer, size, Format(format, args...));
+			return m_length;
+		}
+
+	private:
+		template<typename T>
+		using KeyType = std::conditional_t<std::is_same_v<T, const char*>, std::string, T>;
+
+		std::tuple<std::string, KeyType<Args>...> m_key;
+		char m_buffer[Size];
+		int m_length = -1;
+		uint32_t m_version = 0;
+	};
+}
+
 namespace ConsistentControlsScreen
 {
 	template<std::size_t Index>
@@ -851,8 +968,8 @@ namespace ConsistentControlsScreen
 	template<std::size_t Index>
 	static const char* Language_GetString_Formatted(uint32_t ID)
 	{
-		sprintf_s(gszTempString, 512, " %s", orgLanguage_GetString<Index>(ID));
-		return gszTempString;
+		static FormattedStrings::Cache<512, const char*> cache;
+		return cache.Format(" %s", orgLanguage_GetString<Index>(ID));
 	}
 
 	template<std::size_t Ctr, typename Tuple, std::size_t... I, typename Func>
@@ -886,58 +1003,60 @@ namespace ConsistentControlsScreen
 namespace ConsistentLanguagesScreen
 {
 	// Also supporting multi7 now
-	static const char* GetCoDriverName()
-	{
-		std::vector<uint32_t> coDriverNames = {
-			445, 447, 449, 448, 450, Language::CODRIVER_POLISH_A, Language::CODRIVER_POLISH_B, Language::CODRIVER_CZECH
-		};
+	static constexpr uint32_t CODRIVER_NAMES[] = {
+		445, 447, 449, 448, 450, Language::CODRIVER_POLISH_A, Language::CODRIVER_POLISH_B, Language::CODRIVER_CZECH
+	};
+	static constexpr uint32_t LANGUAGE_NAMES[] = {
+		1, 2, 4, 3, 5, Language::LANGUAGE_POLISH, Language::LANGUAGE_CZECH
+	};
+
+	// Fixed at patch time - Nicky Grist is dropped from the list if his files are absent
+	static const uint32_t* coDriverNames = std::begin(CODRIVER_NAMES);
+	static size_t numCoDriverNames = std::size(CODRIVER_NAMES);
 
+	void SetUpCoDriverNames()
+	{
 		const bool excludeNickyGrist = Menus::Patches::MultipleCoDriversPatched && !Version::HasNickyGristFiles();
-		if (excludeNickyGrist)
-		{
-			coDriverNames.erase(coDriverNames.begin());
-		}
+		coDriverNames = std::begin(CODRIVER_NAMES) + (excludeNickyGrist ? 1 : 0);
+		numCoDriverNames = std::end(CODRIVER_NAMES) - coDriverNames;
+	}
 
-		uint32_t langID = gmoFrontEndMenus[MenuID::LANGUAGE].m_entries[1].m_value;
-		if (langID >= coDriverNames.size())
-		{
-			return Language_GetString(coDriverNames.front());
-		}
-		return Language_GetString(coDriverNames[langID]);
+	static const char* GetCoDriverName()
+	{
+		const uint32_t langID = gmoFrontEndMenus[MenuID::LANGUAGE].m_entries[1].m_value;
+		return Language_GetString(coDriverNames[langID < numCoDriverNames ? langID : 0]);
 	}
 
 	static const char* GetLangName()
 	{
-		const std::array<uint32_t, 7> langNames = {
-			1, 2, 4, 3, 5, Language::LANGUAGE_POLISH, Language::LANGUAGE_CZECH
-		};
-
-		uint32_t langID = gmoFrontEndMenus[MenuID::LANGUAGE].m_entries[0].m_value;
-		if (langID >= langNames.size())
-		{
-			return Language_GetString(langNames.front());
-		}
-		return Language_GetString(langNames[langID]);
+		const uint32_t langID = gmoFrontEndMenus[MenuID::LANGUAGE].m_entries[0].m_value;
+		return Language_GetString(LANGUAGE_NAMES[langID < std::size(LANGUAGE_NAMES) ? langID : 0]);
 	}
 
+	// Hooked at several call sites, each needs its own cache
+	template<std::size_t Index>
 	int __cdecl sprintf_codriver2(char* Buffer, const char* Format, const char* str1, const char* /*str2*/)
 	{
-		return sprintf_s(Buffer, 512, Format, str1, GetCoDriverName());
+		static FormattedStrings::Cache<512, const char*, const char*> cache;
+		return cache.FormatTo(Buffer, 512, Format, str1, GetCoDriverName());
 	}
 
 	int __cdecl sprintf_codriver1(char* Buffer, const char* Format, const char* /*str*/)
 	{
-		return sprintf_s(Buffer, 256, Format, GetCoDriverName());
+		static FormattedStrings::Cache<256, const char*> cache;
+		return cache.FormatTo(Buffer, 256, Format, GetCoDriverName());
 	}
 
 	int __cdecl sprintf_lang2(char* Buffer, const char* Format, const char* str1, const char* /*str2*/)
 	{
-		return sprintf_s(Buffer, 512, Format, str1, GetLangName());
+		static FormattedStrings::Cache<512, const char*, const char*> cache;
+		return cache.FormatTo(Buffer, 512, Format, str1, GetLangName());
 	}
 
 	int __cdecl sprintf_lang1(char* Buffer, const char* Format, const char* /*str*/)
 	{
-		return sprintf_s(Buffer, 256, Format, GetLangName());
+		static FormattedStrings::Cache<256, const char*> cache;
+		return cache.FormatTo(Buffer, 256, Format, GetLangName());
 	}
 }
 
@@ -950,6 +1069,41 @@ namespace MoreTranslatableStrings
 	}
 
 	// Localized keyboard key names
+	static constexpr auto KEY_NAME_IDS = []
+	{
+		std::array<uint16_t, 256> result {};
+		result[1] = 1005; result[14] = 1006; result[15] = 1007; result[28] = 1004;
+		for (uint16_t i = 0; i < 10; i++)
+		{
+			result[59+i] = static_cast<uint16_t>(1008+i); // F1-F10
+		}
+		result[70] = 1021; result[87] = 1018; result[88] = 1019;
+		result[183] = 1020; result[197] = 1022; result[199] = 1024; result[200] = 1031;
+		result[201] = 1025; result[203] = 1030; result[205] = 1029; result[207] = 1027;
+		result[208] = 1032; result[209] = 1028; result[210] = 1023; result[211] = 1026;
+		return result;
+	}();
+
+	// Names resolved for the current language, rebuilt only when the string table changes
+	static const char* GetKeyName(int keyID)
+	{
+		static std::array<const char*, std::size(KEY_NAME_IDS)> keyNames;
+		static const char* unknownKeyName;
+		static std::optional<uint32_t> keyNamesVersion;
+
+		const uint32_t version = Language_GetStringTableVersion();
+		if (keyNamesVersion != version)
+		{
+			std::transform(KEY_NAME_IDS.begin(), KEY_NAME_IDS.end(), keyNames.begin(),
+				[](uint16_t ID) { return ID != 0 ? Language_GetString(ID) : nullptr; });
+			unknownKeyName = Language_GetString(1033);
+			keyNamesVersion = version;
+		}
+
+		const char* name = static_cast<unsigned int>(keyID) < keyNames.size() ? keyNames[keyID] : nullptr;
+		return name != nullptr ? name : unknownKeyName;
+	}
+
 	static char (*Keyboard_ConvertScanCodeToChar)(int keyID, int a2, int a3);
 	int Keyboard_ConvertScanCodeToString(int keyID, char* buffer)
 	{
@@ -962,106 +1116,15 @@ namespace MoreTranslatableStrings
 			return 1;
 		}
 
-		switch ( keyID )
-		{
-		case 1:
-			strcpy_s(buffer, 256, Language_GetString(1005));
-			return 1;
-		case 14:
-			strcpy_s(buffer, 256, Language_GetString(1006));
-			return 1;
-		case 15:
-			strcpy_s(buffer, 256, Language_GetString(1007));
-			return 1;
-		case 28:
-			strcpy_s(buffer, 256, Language_GetString(1004));
-			return 1;
-		case 59:
-			strcpy_s(buffer, 256, Language_GetString(1008));
-			return 1;
-		case 60:
-			strcpy_s(buffer, 256, Language_GetString(1009));
-			return 1;
-		case 61:
-			strcpy_s(buffer, 256, Language_GetString(1010));
-			return 1;
-		case 62:
-			strcpy_s(buffer, 256, Language_GetString(1011));
-			return 1;
-		case 63:
-			strcpy_s(buffer, 256, Language_GetString(1012));
-			return 1;
-		case 64:
-			strcpy_s(buffer, 256, Language_GetString(1013));
-			return 1;
-		case 65:
-			strcpy_s(buffer, 256, Language_GetString(1014));
-			return 1;
-		case 66:
-			strcpy_s(buffer, 256, Language_GetString(1015));
-			return 1;
-		case 67:
-			strcpy_s(buffer, 256, Language_GetString(1016));
-			return 1;
-		case 68:
-			strcpy_s(buffer, 256, Language_GetString(1017));
-			return 1;
-		case 70:
-			strcpy_s(buffer, 256, Language_GetString(1021));
-			return 1;
-		case 87:
-			strcpy_s(buffer, 256, Language_GetString(1018));
-			return 1;
-		case 88:
-			strcpy_s(buffer, 256, Language_GetString(1019));
-			return 1;
-		case 183:
-			strcpy_s(buffer, 256, Language_GetString(1020));
-			return 1;
-		case 197:
-			strcpy_s(buffer, 256, Language_GetString(1022));
-			return 1;
-		case 199:
-			strcpy_s(buffer, 256, Language_GetString(1024));
-			return 1;
-		case 200:
-			strcpy_s(buffer, 256, Language_GetString(1031));
-			return 1;
-		case 201:
-			strcpy_s(buffer, 256, Language_GetString(1025));
-			return 1;
-		case 203:
-			strcpy_s(buffer, 256, Language_GetString(1030));
-			return 1;
-		case 205:
-			strcpy_s(buffer, 256, Language_GetString(1029));
-			return 1;
-		case 207:
-			strcpy_s(buffer, 256, Language_GetString(1027));
-			return 1;
-		case 208:
-			strcpy_s(buffer, 256, Language_GetString(1032));
-			return 1;
-		case 209:
-			strcpy_s(buffer, 256, Language_GetString(1028));
-			return 1;
-		case 210:
-			strcpy_s(buffer, 256, Language_GetString(1023));
-			return 1;
-		case 211:
-			strcpy_s(buffer, 256, Language_GetString(1026));
-			return 1;
-		default:
-			strcpy_s(buffer, 256, Language_GetString(1033));
-			break;
-		}
-		return 0;
+		strcpy_s(buffer, 256, GetKeyName(keyID));
+		return static_cast<unsigned int>(keyID) < KEY_NAME_IDS.size() && KEY_NAME_IDS[keyID] != 0 ? 1 : 0;
 	}
 
 	// Localized "Return to Centre"
 	int __cdecl sprintf_returntocentre1(char* Buffer, const char* Format, const char* /*str*/)
 	{
-		return sprintf_s(Buffer, 256, Format, Language_GetString(Language::RETURN_TO_CENTRE));
+		static FormattedStrings::Cache<256, const char*> cache;
+		return cache.FormatTo(Buffer, 256, Format, Language_GetString(Language::RETURN_TO_CENTRE));
 	}
 
 	int __cdecl sprintf_returntocentre2(char* Buffer, const char* Format, const char* /*str1*/, const char* str2)
@@ -1344,17 +1407,22 @@ namespace SPText
 
 	void DrawSPText(uint32_t color)
 	{
-		const uint32_t alpha = color & 0xFF000000;
-
-		const int16_t ScreenEdge = static_cast<int16_t>(GetScaledResolutionWidth());
+		static TextLayouts::Layout layout;
 		const static std::string DISCLAIMER_TEXT(BuildTextInternal());
 
-		constexpr int16_t DROP_SHADOW_WIDTH = 1;
-		CMR3Font_BlitText(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10 + DROP_SHADOW_WIDTH, 10, alpha, 4);
-		CMR3Font_BlitText(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10 - DROP_SHADOW_WIDTH, 10, alpha, 4);
-		CMR3Font_BlitText(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10 + DROP_SHADOW_WIDTH, alpha, 4);
-		CMR3Font_BlitText(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10 - DROP_SHADOW_WIDTH, alpha, 4);
-		CMR3Font_BlitText(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10, color, 4);
+		if (layout.NeedsRebuild(color & 0xFFFFFF))
+		{
+			const uint32_t COLOR_SHADOW = 0xFF000000;
+			const int16_t ScreenEdge = static_cast<int16_t>(GetScaledResolutionWidth());
+
+			constexpr int16_t DROP_SHADOW_WIDTH = 1;
+			layout.Add(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10 + DROP_SHADOW_WIDTH, 10, COLOR_SHADOW, 4);
+			layout.Add(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10 - DROP_SHADOW_WIDTH, 10, COLOR_SHADOW, 4);
+			layout.Add(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10 + DROP_SHADOW_WIDTH, COLOR_SHADOW, 4);
+			layout.Add(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10 - DROP_SHADOW_WIDTH, COLOR_SHADOW, 4);
+			layout.Add(0, DISCLAIMER_TEXT.c_str(), ScreenEdge - 10, 10, color | 0xFF000000, 4);
+		}
+		layout.Draw(color >> 24);
 	}
 
 	template<std::size_t Index>
@@ -1613,66 +1681,166 @@ namespace HalfPixel
 {
 	using namespace DirectX;
 
-	static float OffsetTexel(float val)
+	// Snaps 4 coordinates to pixel centers at once, as std::ceil(val) - 0.5f
+	// The sign of a zero ceil result is lost when subtracting 0.5, so all variants are bit-identical
+	template<bool UseSSE41>
+	static XMVECTOR OffsetTexel(const XMVECTOR& val)
 	{
-		return std::ceil(val) - 0.5f;
+#if defined(_XM_SSE_INTRINSICS_)
+		if constexpr (UseSSE41)
+		{
+			return _mm_sub_ps(_mm_ceil_ps(val), g_XMOneHalf);
+		}
+		else
+#endif
+		{
+			// SSE2 emulation or a scalar fallback, depending on how DirectXMath is configured
+			return XMVectorSubtract(XMVectorCeiling(val), g_XMOneHalf);
+		}
+	}
+
+	static const bool gHasSSE41 = []
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo, 1);
+		return (cpuInfo[2] & (1 << 19)) != 0;
+	}();
+
+	// Snaps all vertices of the blits in place, requires X and Y arrays to be adjacent
+	template<bool UseSSE41, typename T>
+	static void OffsetTexels_Impl(T* blits, uint32_t numBlits)
+	{
+		constexpr size_t NUM_COORDS = (sizeof(T::X) + sizeof(T::Y)) / sizeof(float);
+		static_assert(offsetof(T, Y) == offsetof(T, X) + sizeof(T::X), "X and Y must be adjacent");
+		static_assert(NUM_COORDS % 4 == 0, "Coordinates must come in multiples of 4");
+
+		for (uint32_t i = 0; i < numBlits; i++)
+		{
+			XMFLOAT4* coords = reinterpret_cast<XMFLOAT4*>(blits[i].X);
+			for (size_t j = 0; j < NUM_COORDS / 4; j++)
+			{
+				XMStoreFloat4(&coords[j], OffsetTexel<UseSSE41>(XMLoadFloat4(&coords[j])));
+			}
+		}
 	}
 
-	static XMVECTOR ComputePoint(float x, float y, const XMMATRIX& rot, const XMVECTOR& trans)
+	template<typename T>
+	static void OffsetTexels(T* blits, uint32_t numBlits)
 	{
-		return XMVectorAdd(trans, XMVector2TransformNormal(XMVectorSet(x, y, 0.0f, 0.0f), rot));
+		if (gHasSSE41)
+		{
+			OffsetTexels_Impl<true>(blits, numBlits);
+		}
+		else
+		{
+			OffsetTexels_Impl<false>(blits, numBlits);
+		}
 	}
 
-	static float ComputeConstantScale(const XMVECTOR& pos, const XMMATRIX& view, const XMFLOAT4X4& proj)
+	struct LineMatrices
 	{
-		const XMVECTOR ppcam0 = XMVector4Transform(pos, view);
-		const XMVECTOR ppcam1 = XMVectorAdd(ppcam0, XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f));
+		D3DMATRIX view;
+		D3DMATRIX projection;
 
-		const XMVECTOR column0 = XMVectorSet(proj.m[0][0], proj.m[1][0], proj.m[2][0], 0.0f);
-		const XMVECTOR column3 = XMVectorSet(proj.m[0][3], proj.m[1][3], proj.m[2][3], 0.0f);
+		XMMATRIX viewMatrix;
+		XMMATRIX invViewMatrix;
+		XMMATRIX projMatrix;
+	};
 
-		const float l1 = 1.0f / (XMVectorGetX(XMVector3Dot(ppcam0, column3)) + proj.m[3][3]);
-		const float c1 = (XMVectorGetX(XMVector3Dot(ppcam0, column0)) + proj.m[3][0]) * l1;
-		const float l2 = 1.0f / (XMVectorGetX(XMVector3Dot(ppcam1, column3)) + proj.m[3][3]);
-		const float c2 = (XMVectorGetX(XMVector3Dot(ppcam1, column0)) + proj.m[3][0]) * l2;
-		return 1.0f / ((c2 - c1) * Viewport_GetCurrent()->m_width);
+	// Scale keeping the line width constant on screen, for a point already in clip space
+	static float ComputeConstantScale(const XMFLOAT4& ppclip, const D3DMATRIX& proj, float viewportWidth)
+	{
+		// Offsetting the point by 1 along the camera X axis only adds the first row of the projection matrix
+		const float c1 = ppclip.x / ppclip.w;
+		const float c2 = (ppclip.x + proj.m[0][0]) / (ppclip.w + proj.m[0][3]);
+		return 1.0f / ((c2 - c1) * viewportWidth);
 	}
 
-	// This and the above functions have been adapted for the game from "Textured Lines In D3D" by Pierre Terdiman
+	// This and the above function have been adapted for the game from "Textured Lines In D3D" by Pierre Terdiman
 	// https://www.flipcode.com/archives/Textured_Lines_In_D3D.shtml
-	void ComputeScreenQuad(const XMMATRIX& inverseview, const XMMATRIX& view, const XMFLOAT4X4* proj, XMVECTOR* verts, const XMVECTOR& p0, const XMVECTOR& p1, float size)
+	// Instead of rotating by atan2 angles, the quad is offset along the normalized camera space perpendicular of the line
+	// Endpoints come in world, camera and clip space, as the hook transforms all lines in a batch up front
+	static void ComputeThickLine3DQuad(const LineMatrices& matrices, float viewportWidth, XMVECTOR* verts, const XMVECTOR& p0, const XMVECTOR& p1,
+		const XMFLOAT4& ppcam0, const XMFLOAT4& ppcam1, const XMFLOAT4& ppclip0, const XMFLOAT4& ppclip1, float size)
 	{
 		// Compute delta in camera space
-		const XMVECTOR Delta = XMVector3TransformNormal(p1-p0, view);
+		const float deltaX = ppcam1.x - ppcam0.x;
+		const float deltaY = ppcam1.y - ppcam0.y;
 
-		// Compute size factors
-		float SizeP0 = size;
-		float SizeP1 = size;
+		// Compute size factors so that screen-size is constant
+		const XMVECTOR SizeP0 = XMVectorReplicate(size * ComputeConstantScale(ppclip0, matrices.projection, viewportWidth));
+		const XMVECTOR SizeP1 = XMVectorReplicate(size * ComputeConstantScale(ppclip1, matrices.projection, viewportWidth));
 
-		if(proj != nullptr)
-		{
-			// Compute scales so that screen-size is constant
-			SizeP0 *= ComputeConstantScale(p0, view, *proj);
-			SizeP1 *= ComputeConstantScale(p1, view, *proj);
-		}
-		else
-		{
-			SizeP0 /= 2.0f;
-			SizeP1 /= 2.0f;
-		}
+		// atan2 of a zero length delta resolves to a horizontal offset, keep it that way
+		const float lengthSq = deltaX * deltaX + deltaY * deltaY;
+		const XMVECTOR perpendicular = lengthSq > 0.0f ? XMVectorScale(XMVectorSet(-deltaY, deltaX, 0.0f, 0.0f), 1.0f / std::sqrt(lengthSq))
+			: XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f);
+		const XMVECTOR offset = XMVector2TransformNormal(perpendicular, matrices.invViewMatrix);
 
 		// Compute quad vertices
-		const float Theta0 = atan2f(-XMVectorGetX(Delta), -XMVectorGetY(Delta));
-		const float c0 = SizeP0 * std::cos(Theta0);
-		const float s0 = SizeP0 * std::sin(Theta0);
-		*verts++ = ComputePoint(c0, -s0, inverseview, p0);
-		*verts++ = ComputePoint(-c0, s0, inverseview, p0);
+		*verts++ = XMVectorMultiplyAdd(offset, SizeP0, p0);
+		*verts++ = XMVectorNegativeMultiplySubtract(offset, SizeP0, p0);
+		*verts++ = XMVectorMultiplyAdd(offset, SizeP1, p1);
+		*verts++ = XMVectorNegativeMultiplySubtract(offset, SizeP1, p1);
+	}
+
+	// 2D-only equivalent of ComputeThickLine3DQuad, for 4 lines at once in structure-of-arrays form
+	// The quad is offset by the line direction rotated by 90 degrees and normalized, so there is no trigonometry involved
+	// This is not bit-exact with the atan2/cos/sin path - e.g. for axis-aligned lines that path leaves a ~4e-8 offset
+	// where this one gives 0, so after snapping a vertex can land at most one pixel away from where it used to
+	// Output vertices are already snapped with OffsetTexel
+	static void ComputeThickLineQuads(const XMVECTOR& x0, const XMVECTOR& y0, const XMVECTOR& x1, const XMVECTOR& y1, float halfThickness,
+		float (&quadX)[4][4], float (&quadY)[4][4])
+	{
+		const XMVECTOR dx = XMVectorSubtract(x1, x0);
+		const XMVECTOR dy = XMVectorSubtract(y1, y0);
+		const XMVECTOR lengthSq = XMVectorMultiplyAdd(dx, dx, XMVectorMultiply(dy, dy));
+		const XMVECTOR scale = XMVectorScale(XMVectorReciprocalSqrt(lengthSq), halfThickness);
+
+		// atan2 of a zero length line resolves to a horizontal offset, keep it that way
+		const XMVECTOR degenerate = XMVectorEqual(lengthSq, XMVectorZero());
+		const XMVECTOR normalX = XMVectorSelect(XMVectorNegate(XMVectorMultiply(dy, scale)), XMVectorReplicate(-halfThickness), degenerate);
+		const XMVECTOR normalY = XMVectorSelect(XMVectorMultiply(dx, scale), XMVectorZero(), degenerate);
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadX[0]), OffsetTexel<false>(XMVectorAdd(x0, normalX)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadY[0]), OffsetTexel<false>(XMVectorAdd(y0, normalY)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadX[1]), OffsetTexel<false>(XMVectorSubtract(x0, normalX)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadY[1]), OffsetTexel<false>(XMVectorSubtract(y0, normalY)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadX[2]), OffsetTexel<false>(XMVectorAdd(x1, normalX)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadY[2]), OffsetTexel<false>(XMVectorAdd(y1, normalY)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadX[3]), OffsetTexel<false>(XMVectorSubtract(x1, normalX)));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(quadY[3]), OffsetTexel<false>(XMVectorSubtract(y1, normalY)));
+	}
+
+	// Reusable scratch buffer for geometry generated by the blitter hooks, replacing per-call _malloca
+	// Blitters copy vertices out before returning, so one buffer is shared by all hooks. It only ever grows and is never reset or freed
+	static std::vector<uint8_t> gScratchBuffer;
+
+	template<typename T>
+	static T* GetScratchBuffer(size_t count)
+	{
+		// Returns nullptr if the buffer can't grow, as exceptions must not leak into game code
+		// Callers then skip drawing that batch of lines, the previous contents are left intact
+		const size_t size = sizeof(T) * count;
+		if (size > gScratchBuffer.size())
+		{
+			try
+			{
+				gScratchBuffer.resize(size);
+			}
+			catch (const std::exception&)
+			{
+				return nullptr;
+			}
 
-		const float Theta1 = atan2f(XMVectorGetX(Delta), XMVectorGetY(Delta));
-		const float c1 = SizeP1 * std::cos(Theta1);
-		const float s1 = SizeP1 * std::sin(Theta1);
-		*verts++ = ComputePoint(-c1, s1, inverseview, p1);
-		*verts++ = ComputePoint(c1, -s1, inverseview, p1);
+#ifdef DEBUG
+			// Report every new peak size
+			char buf[128];
+			sprintf_s(buf, "SilentPatch: Blitter scratch buffer peak usage - %zu bytes\n", size);
+			OutputDebugStringA(buf);
+#endif
+		}
+		return reinterpret_cast<T*>(gScratchBuffer.data());
 	}
 
 	void (*Core_Blitter2D_Tri2D_G)(BlitTri2D_G* tris, uint32_t numTris);
@@ -1694,17 +1862,7 @@ namespace HalfPixel
 
 	void Core_Blitter2D_Rect2D_G_HalfPixel(BlitRect2D_G* verts, uint32_t numVerts)
 	{
-		for (uint32_t i = 0; i < numVerts; i++)
-		{
-			for (float& val : verts[i].X)
-			{
-				val = OffsetTexel(val);
-			}
-			for (float& val : verts[i].Y)
-			{
-				val = OffsetTexel(val);
-			}
-		}
+		OffsetTexels(verts, numVerts);
 		(*gpd3dDevice)->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, FALSE);
 		Core_Blitter2D_Rect2D_G_Original(verts, numVerts);
 		(*gpd3dDevice)->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, TRUE);
@@ -1724,17 +1882,7 @@ namespace HalfPixel
 
 	void Core_Blitter2D_Rect2D_GT_HalfPixel(BlitRect2D_GT* verts, uint32_t numRectangles)
 	{
-		for (uint32_t i = 0; i < numRectangles; i++)
-		{
-			for (float& val : verts[i].X)
-			{
-				val = OffsetTexel(val);
-			}
-			for (float& val : verts[i].Y)
-			{
-				val = OffsetTexel(val);
-			}
-		}
+		OffsetTexels(verts, numRectangles);
 		(*gpd3dDevice)->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, FALSE);
 		Core_Blitter2D_Rect2D_GT_Original(verts, numRectangles);
 		(*gpd3dDevice)->SetRenderState(D3DRS_MULTISAMPLEANTIALIAS, TRUE);
@@ -1754,17 +1902,7 @@ namespace HalfPixel
 
 	void Core_Blitter2D_Quad2D_G_HalfPixel(BlitQuad2D_G* quads, uint32_t numQuads)
 	{
-		for (uint32_t i = 0; i < numQuads; i++)
-		{
-			for (float& val : quads[i].X)
-			{
-				val = OffsetTexel(val);
-			}
-			for (float& val : quads[i].Y)
-			{
-				val = OffsetTexel(val);
-			}
-		}
+		OffsetTexels(quads, numQuads);
 		Core_Blitter2D_Quad2D_G_Original(quads, numQuads);
 	}
 
@@ -1782,17 +1920,7 @@ namespace HalfPixel
 
 	void Core_Blitter2D_Quad2D_GT_HalfPixel(BlitQuad2D_GT* quads, uint32_t numQuads)
 	{
-		for (uint32_t i = 0; i < numQuads; i++)
-		{
-			for (float& val : quads[i].X)
-			{
-				val = OffsetTexel(val);
-			}
-			for (float& val : quads[i].Y)
-			{
-				val = OffsetTexel(val);
-			}
-		}
+		OffsetTexels(quads, numQuads);
 		Core_Blitter2D_Quad2D_GT_Original(quads, numQuads);
 	}
 
@@ -1821,47 +1949,81 @@ namespace HalfPixel
 		}
 #endif
 
-		auto buf = _malloca(sizeof(BlitTri2D_G) * 2 * numLines);
-		if (buf != nullptr)
+		BlitTri2D_G* tris = GetScratchBuffer<BlitTri2D_G>(2 * numLines);
+		if (tris == nullptr)
 		{
-			using namespace DirectX;
+			// Out of memory, these lines are not drawn this time
+			return;
+		}
+
+		const float halfThickness = Viewport_GetCurrent()->m_height / 480.0f / 2.0f;
+
+		BlitTri2D_G* currentTri = tris;
+		for (uint32_t i = 0; i < numLines; i += 4)
+		{
+			// Gather up to 4 lines, the last batch is padded with copies of its last line
+			const uint32_t batchSize = std::min(numLines - i, 4u);
+			const BlitLine2D_G& line0 = lines[i];
+			const BlitLine2D_G& line1 = lines[i + std::min(1u, batchSize - 1)];
+			const BlitLine2D_G& line2 = lines[i + std::min(2u, batchSize - 1)];
+			const BlitLine2D_G& line3 = lines[i + std::min(3u, batchSize - 1)];
 
-			const XMMATRIX identityMatrix = XMMatrixIdentity();
-			const float targetThickness = Viewport_GetCurrent()->m_height / 480.0f;
+			float quadX[4][4], quadY[4][4];
+			ComputeThickLineQuads(XMVectorFloor(XMVectorSet(line0.X[0], line1.X[0], line2.X[0], line3.X[0])),
+				XMVectorFloor(XMVectorSet(line0.Y[0], line1.Y[0], line2.Y[0], line3.Y[0])),
+				XMVectorFloor(XMVectorSet(line0.X[1], line1.X[1], line2.X[1], line3.X[1])),
+				XMVectorFloor(XMVectorSet(line0.Y[1], line1.Y[1], line2.Y[1], line3.Y[1])), halfThickness, quadX, quadY);
 
-			BlitTri2D_G* tris = reinterpret_cast<BlitTri2D_G*>(buf);
-			BlitTri2D_G* currentTri = tris;
-			for (uint32_t i = 0; i < numLines; i++)
+			// Make triangles from quads
+			for (uint32_t j = 0; j < batchSize; j++)
 			{
-				XMVECTOR quad[4];
-				ComputeScreenQuad(identityMatrix, identityMatrix, nullptr, quad, XMVectorSet(std::floor(lines[i].X[0]), std::floor(lines[i].Y[0]), 0.0f, 1.0f),
-													XMVectorSet(std::floor(lines[i].X[1]), std::floor(lines[i].Y[1]), 0.0f, 1.0f), targetThickness);
-
-				// Make triangles from quad
-				currentTri->X[0] = OffsetTexel(XMVectorGetX(quad[1]));
-				currentTri->Y[0] = OffsetTexel(XMVectorGetY(quad[1]));
-				currentTri->X[1] = OffsetTexel(XMVectorGetX(quad[0]));
-				currentTri->Y[1] = OffsetTexel(XMVectorGetY(quad[0]));
-				currentTri->X[2] = OffsetTexel(XMVectorGetX(quad[2]));
-				currentTri->Y[2] = OffsetTexel(XMVectorGetY(quad[2]));
-				currentTri->Z = lines[i].Z[0];
-				std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[0]);
+				const BlitLine2D_G& line = lines[i + j];
+				auto getX = [&quadX, j](size_t vert) { return quadX[vert][j]; };
+				auto getY = [&quadY, j](size_t vert) { return quadY[vert][j]; };
+
+				currentTri->X[0] = getX(1);
+				currentTri->Y[0] = getY(1);
+				currentTri->X[1] = getX(0);
+				currentTri->Y[1] = getY(0);
+				currentTri->X[2] = getX(2);
+				currentTri->Y[2] = getY(2);
+				currentTri->Z = line.Z[0];
+				std::fill(std::begin(currentTri->color), std::end(currentTri->color), line.color[0]);
 				currentTri++;
 
-				currentTri->X[0] = OffsetTexel(XMVectorGetX(quad[2]));
-				currentTri->Y[0] = OffsetTexel(XMVectorGetY(quad[2]));
-				currentTri->X[1] = OffsetTexel(XMVectorGetX(quad[3]));
-				currentTri->Y[1] = OffsetTexel(XMVectorGetY(quad[3]));
-				currentTri->X[2] = OffsetTexel(XMVectorGetX(quad[1]));
-				currentTri->Y[2] = OffsetTexel(XMVectorGetY(quad[1]));
-				currentTri->Z = lines[i].Z[0];
-				std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[1]);
+				currentTri->X[0] = getX(2);
+				currentTri->Y[0] = getY(2);
+				currentTri->X[1] = getX(3);
+				currentTri->Y[1] = getY(3);
+				currentTri->X[2] = getX(1);
+				currentTri->Y[2] = getY(1);
+				currentTri->Z = line.Z[0];
+				std::fill(std::begin(currentTri->color), std::end(currentTri->color), line.color[1]);
 				currentTri++;
 			}
+		}
+
+		Core_Blitter2D_Tri2D_G(tris, 2 * numLines);
+	}
 
-			Core_Blitter2D_Tri2D_G(tris, 2 * numLines);
+	// The view matrix changes at most a few times per frame (once per splitscreen viewport),
+	// so invert it only when its contents change rather than on every batch of lines
+	static const LineMatrices& GetLineMatrices()
+	{
+		static LineMatrices matrices;
+		static bool matricesValid = false;
+
+		if (!matricesValid || memcmp(&matrices.view, pViewMatrix, sizeof(matrices.view)) != 0 || memcmp(&matrices.projection, pProjectionMatrix, sizeof(matrices.projection)) != 0)
+		{
+			matrices.view = *pViewMatrix;
+			matrices.projection = *pProjectionMatrix;
+
+			matrices.viewMatrix = XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(&matrices.view));
+			matrices.invViewMatrix = XMMatrixInverse(nullptr, matrices.viewMatrix);
+			matrices.projMatrix = XMLoadFloat4x4(reinterpret_cast<const XMFLOAT4X4*>(&matrices.projection));
+			matricesValid = true;
 		}
-		_freea(buf);
+		return matrices;
 	}
 
 	static void* Core_Blitter3D_Line3D_G_JumpBack;
@@ -1886,39 +2048,51 @@ namespace HalfPixel
 		}
 #endif
 
-		auto buf = _malloca(sizeof(BlitTri3D_G) * 2 * numLines);
-		if (buf != nullptr)
+		// One scratch allocation holds the output triangles, followed by camera and clip space endpoints (p0, p1 per line)
+		uint8_t* scratch = GetScratchBuffer<uint8_t>((2 * sizeof(BlitTri3D_G) + 4 * sizeof(XMFLOAT4)) * numLines);
+		if (scratch == nullptr)
 		{
-			const XMMATRIX viewMatrix = XMLoadFloat4x4(reinterpret_cast<XMFLOAT4X4*>(pViewMatrix));
-			const XMMATRIX invViewMatrix = XMMatrixInverse(nullptr, viewMatrix);
+			// Out of memory, these lines are not drawn this time
+			return;
+		}
 
-			const float targetThickness = Graphics_GetScreenHeight() / 480.0f;
+		BlitTri3D_G* tris = reinterpret_cast<BlitTri3D_G*>(scratch);
+		XMFLOAT4* camPoints = reinterpret_cast<XMFLOAT4*>(tris + 2 * numLines);
+		XMFLOAT4* clipPoints = camPoints + 2 * numLines;
 
-			BlitTri3D_G* tris = reinterpret_cast<BlitTri3D_G*>(buf);
-			BlitTri3D_G* currentTri = tris;
-			for (uint32_t i = 0; i < numLines; i++)
-			{
-				XMVECTOR quad[4];
-				ComputeScreenQuad(invViewMatrix, viewMatrix, reinterpret_cast<const XMFLOAT4X4*>(pProjectionMatrix), quad,
-					XMVectorSet(lines[i].X1, lines[i].Y1, lines[i].Z1, 1.0f), XMVectorSet(lines[i].X2, lines[i].Y2, lines[i].Z2, 1.0f), targetThickness);
-
-				// Make triangles from quad
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X1), quad[1]);
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X2), quad[0]);
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X3), quad[2]);
-				std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[0]);
-				currentTri++;
+		const LineMatrices& matrices = GetLineMatrices();
+		const float viewportWidth = static_cast<float>(Viewport_GetCurrent()->m_width);
+		const float targetThickness = Graphics_GetScreenHeight() / 480.0f;
 
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X1), quad[2]);
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X2), quad[3]);
-				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X3), quad[1]);
-				std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[1]);
-				currentTri++;
-			}
+		// Transform all endpoints to camera space and then clip space in batches, W of the source points is ignored and treated as 1
+		constexpr size_t POINT_STRIDE = 2 * sizeof(XMFLOAT4);
+		XMVector3TransformStream(&camPoints[0], POINT_STRIDE, reinterpret_cast<const XMFLOAT3*>(&lines->X1), sizeof(*lines), numLines, matrices.viewMatrix);
+		XMVector3TransformStream(&camPoints[1], POINT_STRIDE, reinterpret_cast<const XMFLOAT3*>(&lines->X2), sizeof(*lines), numLines, matrices.viewMatrix);
+		XMVector3TransformStream(clipPoints, sizeof(XMFLOAT4), reinterpret_cast<const XMFLOAT3*>(camPoints), sizeof(XMFLOAT4), 2 * numLines, matrices.projMatrix);
+
+		BlitTri3D_G* currentTri = tris;
+		for (uint32_t i = 0; i < numLines; i++)
+		{
+			XMVECTOR quad[4];
+			ComputeThickLine3DQuad(matrices, viewportWidth, quad,
+				XMVectorSet(lines[i].X1, lines[i].Y1, lines[i].Z1, 1.0f), XMVectorSet(lines[i].X2, lines[i].Y2, lines[i].Z2, 1.0f),
+				camPoints[2 * i], camPoints[2 * i + 1], clipPoints[2 * i], clipPoints[2 * i + 1], targetThickness);
+
+			// Make triangles from quad
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X1), quad[1]);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X2), quad[0]);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X3), quad[2]);
+			std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[0]);
+			currentTri++;
 
-			Core_Blitter3D_Tri3D_G(tris, 2 * numLines);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X1), quad[2]);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X2), quad[3]);
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&currentTri->X3), quad[1]);
+			std::fill(std::begin(currentTri->color), std::end(currentTri->color), lines[i].color[1]);
+			currentTri++;
 		}
-		_freea(buf);
+
+		Core_Blitter3D_Tri3D_G(tris, 2 * numLines);
 	}
 }
 
@@ -2440,32 +2614,83 @@ namespace ScaledTexturesSupport
 		HookEachImpl_Misc_Scaled<Ctr>(std::move(tuple), std::make_index_sequence<std::tuple_size_v<decltype(tuple)>>{}, std::forward<Func>(f));
 	}
 
-	static uint32_t nextFontScale = 1;
-	static bool nextFontNearest = false;
+	struct FontSettings
+	{
+		uint32_t scale = 1;
+		bool useNearest = false;
+	};
+
+	// Settings of all fonts in a single directory, keyed by a lowercase font name
+	using FontSettingsMap = std::map<std::wstring, FontSettings, std::less<>>;
+
+	static std::wstring ToLowerFontName(std::string_view name)
+	{
+		std::wstring result;
+		std::transform(name.begin(), name.end(), std::back_inserter(result), [](char ch) { return static_cast<wchar_t>(::tolower(static_cast<unsigned char>(ch))); });
+		return result;
+	}
+
+	static FontSettingsMap ParseFontsIni(const std::filesystem::path& iniPath)
+	{
+		FontSettingsMap result;
+
+		// Use hardcoded defaults if there is no INI entry for this font
+		for (const wchar_t* fontName : { L"kro_20", L"gears", L"time", L"speed" })
+		{
+			result[fontName].useNearest = true;
+		}
+
+		std::wstring sectionNames(1024, L'\0');
+		DWORD length;
+		while ((length = GetPrivateProfileSectionNamesW(sectionNames.data(), static_cast<DWORD>(sectionNames.size()), iniPath.c_str())) == sectionNames.size() - 2)
+		{
+			sectionNames.resize(sectionNames.size() * 2);
+		}
+		sectionNames.resize(length);
+
+		for (const wchar_t* section = sectionNames.c_str(); *section != L'\0'; section += wcslen(section) + 1)
+		{
+			std::wstring fontName(section);
+			std::transform(fontName.begin(), fontName.end(), fontName.begin(), ::towlower);
+
+			FontSettings& settings = result[fontName];
+			settings.scale = GetPrivateProfileIntW(section, L"Scale", 1, iniPath.c_str());
+
+			UINT useNearestFilter = GetPrivateProfileIntW(section, L"NearestFilter", -1, iniPath.c_str());
+			if (useNearestFilter != -1)
+			{
+				settings.useNearest = useNearestFilter != 0;
+			}
+		}
+		return result;
+	}
+
+	static const FontSettings* nextFontSettings = nullptr;
 
 	static char* (*PlatformiseTextureFilename)(char* path);
 	static char* PlatformiseTextureFilename_GetScale(char* path)
 	{
+		// Every fonts.ini is read only once, the first time a font is loaded from its directory
+		static std::map<std::string, FontSettingsMap, std::less<>> fontsIniFiles;
+
 		char* result = PlatformiseTextureFilename(path);
 
 		// With merged locales, this path point at a subdirectory, so be mindful
-		const std::filesystem::path stdPath(result);
-		const std::filesystem::path iniPath = GetPathToGameDir() / stdPath.parent_path() / L"fonts.ini";
-		const std::wstring fontName = stdPath.stem();
+		const std::string_view fontPath(result);
+		const size_t nameStart = fontPath.find_last_of("\\/") + 1; // npos + 1 wraps to 0
+		const std::string_view fontDir = fontPath.substr(0, nameStart);
+		const std::string_view fontFileName = fontPath.substr(nameStart);
 
-		nextFontScale = GetPrivateProfileIntW(fontName.c_str(), L"Scale", 1, iniPath.c_str());
-		UINT useNearestFilter = GetPrivateProfileIntW(fontName.c_str(), L"NearestFilter", -1, iniPath.c_str());
-		if (useNearestFilter == -1)
+		auto dirIt = fontsIniFiles.find(fontDir);
+		if (dirIt == fontsIniFiles.end())
 		{
-			// Use hardcoded defaults if there is no INI entry for this font
-			static const std::wstring_view fontsWithNearest[] = { L"kro_20", L"gears", L"time", L"speed" };
-			nextFontNearest = std::find(std::begin(fontsWithNearest), std::end(fontsWithNearest), fontName) != std::end(fontsWithNearest);
-		}
-		else
-		{
-			nextFontNearest = useNearestFilter != 0;
+			dirIt = fontsIniFiles.emplace(fontDir, ParseFontsIni(GetPathToGameDir() / std::filesystem::path(fontDir) / L"fonts.ini")).first;
 		}
 
+		const FontSettingsMap& fontsSettings = dirIt->second;
+		auto fontIt = fontsSettings.find(ToLowerFontName(fontFileName.substr(0, fontFileName.find_last_of('.'))));
+		nextFontSettings = fontIt != fontsSettings.end() ? &fontIt->second : nullptr;
+
 		return result;
 	}
 
@@ -2473,13 +2698,23 @@ namespace ScaledTexturesSupport
 	D3DTexture* CreateTexture_Font_Scaled(void* a1, const char* name, int a3, int a4, int a5)
 	{
 		D3DTexture* result = orgCreateTexture_Font(a1, name, a3, a4, a5);
+
+		// A reloaded font may come with a different scale from fonts.ini
+		CMR3Font_InvalidateTextWidths();
+
+		static const FontSettings DEFAULT_SETTINGS;
+		const FontSettings* settings = std::exchange(nextFontSettings, nullptr);
+		if (settings == nullptr)
+		{
+			settings = &DEFAULT_SETTINGS;
+		}
+
 		if (result != nullptr)
 		{
-			const uint32_t scale = std::exchange(nextFontScale, 1);
-			result->m_width /= scale;
-			result->m_height /= scale;
+			result->m_width /= settings->scale;
+			result->m_height /= settings->scale;
 
-			if (std::exchange(nextFontNearest, false))
+			if (settings->useNearest)
 			{
 				Core_Texture_SetFilteringMethod(result, D3DTEXF_POINT, D3DTEXF_POINT, D3DTEXF_POINT);
 			}
@@ -3566,10 +3801,10 @@ static void ApplyMergedLocalizations(const bool HasRegistry, const bool HasFront
 		auto lang1 = get_pattern("E8 ? ? ? ? 83 C4 0C 68 ? ? ? ? 6A 00 E8 ? ? ? ? 03 C7 55 8B 4C 24 20");
 
 		InjectHook(codriver1, sprintf_codriver1);
-		for (void* addr : codriver2)
-		{
-			InjectHook(addr, sprintf_codriver2);
-		}
+		InjectHook(codriver2[0], sprintf_codriver2<0>);
+		InjectHook(codriver2[1], sprintf_codriver2<1>);
+		InjectHook(codriver2[2], sprintf_codriver2<2>);
+		InjectHook(codriver2[3], sprintf_codriver2<3>);
 
 		InjectHook(lang2, sprintf_lang2);
 		InjectHook(lang1, sprintf_lang1);
@@ -3727,6 +3962,7 @@ static void ApplyMergedLocalizations(const bool HasRegistry, const bool HasFront
 		InjectHook(sprintf_cod, Localization::sprintf_cod);
 
 		Menus::Patches::MultipleCoDriversPatched = true;
+		ConsistentLanguagesScreen::SetUpCoDriverNames();
 	}
 	TXN_CATCH();
 }
@@ -5705,7 +5941,7 @@ static void ApplyPatches(const bool HasRegistry)
 	TXN_CATCH();
 
 	// Additional Graphics options
-	// FOV Control, Split Screen, Digital tacho
+	// FOV Control, Split Screen, Digital tacho, Graphics profiles
 	// Requires patches: Registry (for saving/loading)
 	if (HasRegistry) try
 	{
@@ -5836,7 +6072,7 @@ static void ApplyPatches(const bool HasRegistry)
 			void** orgJumpTable = *graphics_display_jump_table_ptr;
 			static const void* graphics_display_new_jump_table[EntryID::GRAPHICS_NUM] = {
 				orgJumpTable[0], orgJumpTable[1], orgJumpTable[2], orgJumpTable[3],
-				graphics_display_new_case, graphics_display_new_case, graphics_display_new_case, graphics_display_new_case,
+				graphics_display_new_case, graphics_display_new_case, graphics_display_new_case, graphics_display_new_case, graphics_display_new_case,
 				orgJumpTable[4], orgJumpTable[5]
 			};
 			Patch(graphics_display_jump_table_ptr, &graphics_display_new_jump_table);